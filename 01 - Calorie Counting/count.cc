@@ -1,24 +1,42 @@
 #include <algorithm>
+#include <charconv>
 #include <fmt/format.h>
-#include <fstream>
-#include <string>
+#include <string_view>
 #include <vector>
 
-int main(int, char **argv) {
-    std::ifstream infile{argv[1]};
+#include "parallelparse.hpp"
+
+// calories of every elf in the chunk
+std::vector<int64_t> countChunk(std::string_view chunk) {
     std::vector<int64_t> calories{};
-    std::string line{};
-    while (!infile.eof()) {
-        int64_t currentCalories = 0;
-        while (std::getline(infile, line)) {
-            if (line.size() == 0) {
-                break;
-            }
-            currentCalories += std::stol(line);
+    int64_t currentCalories = 0;
+    bool carrying = false;
+    forEachLine(chunk, [&](std::string_view line) {
+        if (line.size() == 0) {
+            calories.push_back(currentCalories);
+            currentCalories = 0;
+            carrying = false;
+            return;
         }
-        fmt::print("{}\n", currentCalories);
+        int64_t snack = 0;
+        std::from_chars(line.data(), line.data() + line.size(), snack);
+        currentCalories += snack;
+        carrying = true;
+    });
+    if (carrying) {
         calories.push_back(currentCalories);
     }
+    return calories;
+}
+
+int main(int, char **argv) {
+    auto calories = parallelParse(argv[1], Records::blocks, countChunk,
+                                  [](auto &all, auto &&chunk) {
+                                      all.insert(all.end(), chunk.begin(), chunk.end());
+                                  });
+    for (const auto currentCalories : calories) {
+        fmt::print("{}\n", currentCalories);
+    }
     fmt::print("\n");
     std::sort(calories.begin(), calories.end(),
               [](auto a, auto b) { return a > b; });
@@ -1,9 +1,16 @@
 #include <fmt/format.h>
+#include <string_view>
 
+#include "parallelparse.hpp"
 #include "simpleparser.hpp"
 
-int main(int, char **argv) {
-    SimpleParser assigns{argv[1]};
+struct Overlaps {
+    int64_t overlapCounter{};
+    int64_t partialOverlaps{};
+};
+
+Overlaps countOverlaps(std::string_view chunk) {
+    SimpleParser assigns{chunk};
     int64_t overlapCounter = 0;
     int64_t partialOverlaps = 0;
     while (!assigns.isEof()) {
@@ -27,6 +34,15 @@ int main(int, char **argv) {
             ++partialOverlaps;
         }
     }
+    return {overlapCounter, partialOverlaps};
+}
+
+int main(int, char **argv) {
+    const auto [overlapCounter, partialOverlaps] =
+        parallelParse(argv[1], Records::lines, countOverlaps, [](Overlaps &sum, Overlaps &&chunk) {
+            sum.overlapCounter += chunk.overlapCounter;
+            sum.partialOverlaps += chunk.partialOverlaps;
+        });
     fmt::print("I have detected {} total overlaps\n", overlapCounter);
     fmt::print("And there are a total of {} partial overlaps\n",
                partialOverlaps);
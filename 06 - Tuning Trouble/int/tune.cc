@@ -1,4 +1,3 @@
-#include <chrono>
 #include <fmt/format.h>
 #include <fstream>
 #include <queue>
@@ -6,6 +5,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "profiler.hpp"
+
 using std::views::iota;
 
 struct Window {
@@ -43,8 +44,6 @@ struct Window {
 };
 
 int main(int argc, char **argv) {
-    auto startTime = std::chrono::high_resolution_clock::now();
-
     if (argc != 3) {
         fmt::print("Usage: {} inputfile prefix_length\n", argv[0]);
         std::exit(EXIT_FAILURE);
@@ -56,13 +55,15 @@ int main(int argc, char **argv) {
     Window window{prefixLength};
 
     std::vector<int64_t> message;
-    std::string line;
-    while (std::getline(infile, line)) {
-        message.push_back(std::stol(line));
+    {
+        ScopedTimer timer{"parse"};
+        std::string line;
+        while (std::getline(infile, line)) {
+            message.push_back(std::stol(line));
+        }
     }
 
-    auto parse = std::chrono::high_resolution_clock::now();
-
+    ScopedTimer timer{"solve"};
     for (const auto position : iota(0, prefixLength - 1)) {
         window.push(message, position);
     }
@@ -74,17 +75,4 @@ int main(int argc, char **argv) {
             break;
         }
     }
-
-    auto solve = std::chrono::high_resolution_clock::now();
-
-    fmt::print("Time for parsing: {:.4f} ms\n",
-               std::chrono::duration_cast<std::chrono::duration<double>>(
-                   parse - startTime)
-                       .count() *
-                   1000.);
-    fmt::print(
-        "Time for solving: {:4f} ms\n",
-        std::chrono::duration_cast<std::chrono::duration<double>>(solve - parse)
-                .count() *
-            1000.);
 }
@@ -4,10 +4,13 @@
 #include <set>
 #include <string>
 
+#include "allocationcounter.hpp"
+
 using std::views::iota;
 
 void tuneIn(const std::string &message, const size_t length,
             const std::string &what) {
+    ScopedTimer timer{"tuneIn"};
     for (const auto marker : iota(0u, message.size() - length)) {
         std::set<char> sent{};
         for (const auto index : iota(0u, length)) {
@@ -1,17 +1,24 @@
 #include <algorithm>
 #include <fmt/format.h>
-#include <fstream>
 #include <limits>
-#include <map>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "simpleparser.hpp"
+#include "symboltable.hpp"
+
+// all file and directory names, nodes only keep the id
+SymbolTable names{};
+const uint32_t parentName = names.intern("..");
 
 struct Node {
-    const std::string name{};
+    const uint32_t name{};
     const bool isDirectory = false;
 
-    Node(const std::string &name, bool dir) : name(name), isDirectory(dir) {}
+    Node(const uint32_t name, bool dir) : name(name), isDirectory(dir) {}
     virtual ~Node() = default;
     virtual size_t getSize() const = 0;
 };
@@ -22,17 +29,17 @@ class File;
 struct File : public Node {
     size_t size{};
 
-    File(const std::string &name, size_t size)
+    File(const uint32_t name, size_t size)
         : Node(name, false), size(size) {}
     virtual ~File() override = default;
     virtual size_t getSize() const override { return size; }
 };
 
 struct Directory : public Node {
-    std::map<std::string, Node *> entries{};
+    std::unordered_map<uint32_t, Node *> entries{};
     Directory *parent = nullptr;
 
-    Directory(const std::string &name) : Node(name, true) {}
+    Directory(const uint32_t name) : Node(name, true) {}
     virtual ~Directory() override {
         for (const auto &[_, node] : entries) {
             delete node;
@@ -45,27 +52,31 @@ struct Directory : public Node {
         }
         return total;
     }
-    Directory *getDirectory(const std::string name) {
-        if (name == "..") {
+    Directory *getDirectory(const uint32_t name) {
+        if (name == parentName) {
             return parent != nullptr ? parent : this;
         }
-        Node *dst = entries.at(name);
+        const auto entry = entries.find(name);
+        if (entry == entries.end()) {
+            throw std::out_of_range(std::string{names.name(name)});
+        }
+        Node *dst = entry->second;
         if (dst->isDirectory) {
             return static_cast<Directory *>(dst);
         } else {
-            fmt::print("cd: {}: No such file or directory\n", name);
+            fmt::print("cd: {}: No such file or directory\n", names.name(name));
             return this;
         }
     }
     void insert(File *file) {
         if (entries.contains(file->name)) {
-            fmt::print("insert: {}: Node already exists\n", file->name);
+            fmt::print("insert: {}: Node already exists\n", names.name(file->name));
         }
         entries[file->name] = file;
     }
     void insert(Directory *dir) {
         if (entries.contains(dir->name)) {
-            fmt::print("insert: {}: Node already exists\n", dir->name);
+            fmt::print("insert: {}: Node already exists\n", names.name(dir->name));
         }
         entries[dir->name] = dir;
         dir->parent = this;
@@ -86,12 +97,18 @@ struct Directory : public Node {
 };
 
 void ls(Directory *dir, const std::string prefix = "") {
-    fmt::print("{}- {} (dir)\n", prefix, dir->name);
+    fmt::print("{}- {} (dir)\n", prefix, names.name(dir->name));
+    // entries are unordered, list them by name
+    std::vector<Node *> sorted{};
     for (const auto node : *dir) {
+        sorted.push_back(node);
+    }
+    std::ranges::sort(sorted, {}, [](const Node *node) { return names.name(node->name); });
+    for (const auto node : sorted) {
         if (node->isDirectory) {
             ls(static_cast<Directory *>(node), prefix + "  ");
         } else {
-            fmt::print("  {}- {} (file, size={})\n", prefix, node->name,
+            fmt::print("  {}- {} (file, size={})\n", prefix, names.name(node->name),
                        node->getSize());
         }
     }
@@ -127,19 +144,18 @@ size_t removalCandidate(Directory *dir, const size_t minSize) {
 }
 
 int main(int, char **argv) {
-    std::ifstream infile{argv[1]};
-    SimpleParser shell{infile};
+    SimpleParser shell{argv[1]};
 
-    Directory *root = new Directory("/");
+    Directory *root = new Directory(names.intern("/"));
     Directory *cwd = root;
 
     shell.skipToken("$ cd /");
     while (!shell.isEof()) {
         if (shell.skipChar('$')) {
-            const std::string command = shell.getToken();
+            const auto command = shell.getTokenView();
             if (command == "cd") {
                 // cd $dir
-                const std::string dir = shell.getToken();
+                const auto dir = names.intern(shell.getTokenView());
                 cwd = cwd->getDirectory(dir);
             } else if (command == "ls") {
                 // ls
@@ -148,14 +164,14 @@ int main(int, char **argv) {
             }
         } else if (shell.skipToken("dir")) {
             // "dir" dirname
-            const std::string name = shell.getToken();
+            const auto name = names.intern(shell.getTokenView());
 
             Directory *dir = new Directory(name);
             cwd->insert(dir);
         } else {
             // size filename
             const size_t size = shell.getInt64();
-            const std::string name = shell.getToken();
+            const auto name = names.intern(shell.getTokenView());
 
             File *file = new File(name, size);
             cwd->insert(file);
@@ -5,17 +5,32 @@
 #include <map>
 #include <ranges>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
+#include "boundingbox.hpp"
+#include "chunkedbitgrid2.hpp"
 #include "simpleparser.hpp"
 #include "utility.hpp"
 #include "vec2.hpp"
 
 using std::views::iota;
 
-std::unordered_set<Vec2l> visited1{{0, 0}};
-std::unordered_set<Vec2l> visited9{{0, 0}};
+// the locations a knot visited, all knots start at {0, 0}
+struct Visited {
+    ChunkedBitGrid2 cells{};
+    BoundingBoxTracker<Vec2l> bounds{{0, 0}};
+
+    Visited() { cells.insert({0, 0}); }
+
+    void insert(const Vec2l &pos) {
+        cells.insert(pos);
+        bounds.add(pos);
+    }
+    size_t size() const { return cells.size(); }
+};
+
+Visited visited1{};
+Visited visited9{};
 
 static const std::map<std::string, Vec2l> directions{
     {"R", {1, 0}}, {"L", {-1, 0}}, {"U", {0, -1}}, {"D", {0, 1}}};
@@ -54,18 +69,12 @@ struct Rope {
     }
 };
 
-void printVisited(const auto &visited) {
-    Vec2l minPos{0, 0};
-    Vec2l maxPos{0, 0};
-
-    for (const auto &pos : visited) {
-        minPos = {std::min(minPos.x, pos.x), std::min(minPos.y, pos.y)};
-        maxPos = {std::max(maxPos.x, pos.x), std::max(maxPos.y, pos.y)};
-    }
+void printVisited(const Visited &visited) {
+    const auto [minPos, maxPos] = boundingBox(visited.bounds);
 
     for (const auto y : iota(minPos.y - 1, maxPos.y + 2)) {
         for (const auto x : iota(minPos.x - 1, maxPos.x + 2)) {
-            if (visited.contains({x, y})) {
+            if (visited.cells.contains({x, y})) {
                 fmt::print("#");
             } else {
                 fmt::print(".");
@@ -35,11 +35,10 @@ struct Monkey {
         input.skipChar(':');
         // Starting items: 79, 98
         input.skipToken("Starting items:");
-        do {
-            const auto worry = input.getInt64();
-            items.push_back(worry);
+        input.getInt64s(items, ",");
+        for (const auto worry : items) {
             worries.push_back(std::log10(worry));
-        } while (input.skipChar(','));
+        }
         // Operation: new = old * 19
         input.skipToken("Operation: new = old");
         const auto t1 = input.getToken();
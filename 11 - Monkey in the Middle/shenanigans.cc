@@ -30,9 +30,7 @@ struct Monkey {
         input.skipChar(':');
         // Starting items: 79, 98
         input.skipToken("Starting items:");
-        do {
-            items.push_back(input.getInt64());
-        } while (input.skipChar(','));
+        input.getInt64s(items, ",");
         // Operation: new = old * 19
         input.skipToken("Operation: new = old");
         const auto t1 = input.getToken();
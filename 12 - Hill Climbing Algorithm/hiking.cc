@@ -1,71 +1,86 @@
 #include <algorithm>
 #include <fmt/format.h>
-#include <fstream>
 #include <iostream>
 #include <ranges>
-#include <string>
+#include <utility>
 #include <vector>
 
+#include "graphsearch.hpp"
+#include "grid2d.hpp"
 #include "vec2.hpp"
 
 using std::views::iota;
 
-const std::vector<Vec2<size_t>> directions = {
-    {-1ULL, 0}, {1, 0}, {0, -1ULL}, {0, 1}};
+const std::vector<Vec2l> directions = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
 
-std::vector<std::string> heightmap;
-Vec2<size_t> mapSize;
-Vec2<size_t> startPos;
-Vec2<size_t> endPos;
+// the border is lower than any square and can't be climbed
+Grid2D<char> heightmap;
+Vec2l startPos;
+Vec2l endPos;
 
-std::vector<std::vector<int64_t>> distmap;
+// -1 for unvisited squares, the border is never visited
+constexpr int64_t unvisited = -1;
+constexpr int64_t outside = -2;
+Grid2D<int64_t> distmap;
 
 void printDistmap() {
-    for (const auto y : iota(0u, mapSize.y)) {
-        for (const auto x : iota(0u, mapSize.x)) {
-            fmt::print("{:4d}", distmap[y][x]);
+    for (const auto y : iota(0, distmap.height())) {
+        for (const auto x : iota(0, distmap.width())) {
+            fmt::print("{:4d}", distmap[Vec2l{x, y}]);
         }
         fmt::print("\n");
     }
     fmt::print("\n");
 }
 
-std::pair<int64_t, int64_t> fillDistmap() {
-    distmap[endPos.y][endPos.x] = 0;
-    int64_t step = 1;
-    int64_t hikingStep = 0;
-    while (true) {
-        for (const auto y : iota(0u, mapSize.y)) {
-            for (const auto x : iota(0u, mapSize.x)) {
-                if (distmap[y][x] != step - 1) {
-                    continue;
-                }
-                const Vec2<size_t> pos{x, y};
-                for (const auto &direction : directions) {
-                    const auto dst{direction + pos};
-                    if (dst.x >= mapSize.x or dst.y >= mapSize.y) {
-                        continue;
-                    }
-                    if (distmap[dst.y][dst.x] != -1) {
-                        continue;
-                    }
-                    if (heightmap[dst.y][dst.x] + 1 >= heightmap[y][x]) {
-                        distmap[dst.y][dst.x] = step;
-                        if (heightmap[dst.y][dst.x] == 'a' and
-                            hikingStep == 0) {
-                            hikingStep = step;
-                            fmt::print("Hiking start point {}\n", dst);
-                        }
-                        if (dst == startPos) {
-                            return {step, hikingStep};
-                        }
-                    }
+bool canClimb(const Vec2l &from, const Vec2l &to) { return heightmap[from] + 1 >= heightmap[to]; }
+
+// The 'a' square at distance step the hike starts from. It is the first
+// one reached when the squares at step - 1 are taken row by row, each in
+// the order of directions.
+Vec2l hikingStart(const int64_t step) {
+    for (const auto y : iota(0, distmap.height())) {
+        for (const auto x : iota(0, distmap.width())) {
+            const Vec2l pos{x, y};
+            if (distmap[pos] != step - 1) {
+                continue;
+            }
+            for (const auto &direction : directions) {
+                const auto dst{direction + pos};
+                // the search may have stopped before reaching all of step
+                if (heightmap[dst] == 'a' and canClimb(dst, pos) and
+                    (distmap[dst] == step or distmap[dst] == unvisited)) {
+                    return dst;
                 }
             }
         }
-        ++step;
-        // printDistmap();
     }
+    return endPos;
+}
+
+// breadth first search down from the top
+std::pair<int64_t, int64_t> fillDistmap() {
+    distmap[endPos] = 0;
+    int64_t hikingStep = 0;
+    const auto step = GraphSearch::bfs(
+        std::vector{endPos},
+        [&](const Vec2l &pos, auto emit) {
+            for (const auto &direction : directions) {
+                const auto dst{direction + pos};
+                if (distmap[dst] == unvisited and canClimb(dst, pos)) {
+                    distmap[dst] = distmap[pos] + 1;
+                    emit(dst);
+                }
+            }
+        },
+        [&](const Vec2l &pos, const int64_t distance) {
+            if (heightmap[pos] == 'a' and hikingStep == 0) {
+                hikingStep = distance;
+            }
+            return pos == startPos;
+        });
+    fmt::print("Hiking start point {}\n", hikingStart(hikingStep));
+    return {step, hikingStep};
 }
 
 int main(int argc, char **argv) {
@@ -74,26 +89,12 @@ int main(int argc, char **argv) {
         std::exit(EXIT_FAILURE);
     }
 
-    std::ifstream infile{argv[1]};
-    std::string line;
-    size_t y = 0;
-    while (std::getline(infile, line)) {
-        auto x = line.find('S');
-        if (x != std::string::npos) {
-            startPos = {x, y};
-            line[x] = 'a';
-        }
-        x = line.find('E');
-        if (x != std::string::npos) {
-            endPos = {x, y};
-            line[x] = 'z';
-        }
-        heightmap.push_back(line);
-        ++y;
-        distmap.resize(y);
-        distmap[y - 1].resize(line.size(), -1);
-    }
-    mapSize = {heightmap.front().size(), y};
+    heightmap = loadGrid(argv[1], 1, '\0');
+    startPos = heightmap.find('S').value();
+    endPos = heightmap.find('E').value();
+    heightmap[startPos] = 'a';
+    heightmap[endPos] = 'z';
+    distmap = Grid2D<int64_t>{heightmap.size(), unvisited, 1, outside};
 
     const auto [part1, part2] = fillDistmap();
     // printDistmap();
@@ -8,6 +8,7 @@
 #include <variant>
 #include <vector>
 
+#include "allocationcounter.hpp"
 #include "simpleparser.hpp"
 
 using std::views::iota;
@@ -87,11 +88,16 @@ int main(int argc, char **argv) {
     int64_t pair = 0;
     int64_t indexSum = 0;
     while (!scanner.isEof()) {
+        ScopedTimer timer{"pairs"};
         scanner.skipChar('[');
         Value left{readList(scanner)};
         scanner.skipChar('[');
         Value right{readList(scanner)};
-        bool rightOrder = left < right;
+        bool rightOrder = false;
+        {
+            ScopedTimer compare{"compare"};
+            rightOrder = left < right;
+        }
         fmt::print("Pair {} is {}in the right order\n", ++pair,
                    rightOrder ? "" : "not ");
         if (rightOrder) {
@@ -106,6 +112,7 @@ int main(int argc, char **argv) {
     Value d1{std::vector<Value>{{std::vector<Value>{{6}}}}};
     orderedData.insert(d0);
     orderedData.insert(d1);
+    ScopedTimer timer{"dividers"};
     int64_t index = 1;
     int64_t indexProd = 1;
     for (const auto &value : orderedData) {
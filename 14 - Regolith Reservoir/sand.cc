@@ -4,9 +4,11 @@
 #include <iostream>
 #include <ranges>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "boundingbox.hpp"
+#include "chunkedbitgrid2.hpp"
+#include "sidecar.hpp"
 #include "simpleparser.hpp"
 #include "vec2.hpp"
 
@@ -18,19 +20,23 @@ template <typename T> static constexpr T signum(const T num) {
     return (T{0} < num) - (num < T{0});
 }
 
-void printGrid(const auto &map) {
-    Vec2l minPos{sandStart};
-    Vec2l maxPos{sandStart};
+// rock and sand both block falling sand, sand is also kept apart for printing
+struct Cave {
+    ChunkedBitGrid2 blocked{};
+    ChunkedBitGrid2 sand{};
+    // grows with the ends of rock lines and resting sand
+    BoundingBoxTracker<Vec2l> bounds{sandStart};
+};
 
-    for (const auto &[pos, _] : map) {
-        minPos = {std::min(minPos.x, pos.x), std::min(minPos.y, pos.y)};
-        maxPos = {std::max(maxPos.x, pos.x), std::max(maxPos.y, pos.y)};
-    }
+void printGrid(const Cave &cave) {
+    const auto [minPos, maxPos] = boundingBox(cave.bounds);
 
     for (const auto y : iota(minPos.y - 1, maxPos.y + 2)) {
         for (const auto x : iota(minPos.x - 1, maxPos.x + 2)) {
-            if (map.contains({x, y})) {
-                fmt::print("{}", map.at({x, y}));
+            if (cave.sand.contains({x, y})) {
+                fmt::print("o");
+            } else if (cave.blocked.contains({x, y})) {
+                fmt::print("#");
             } else if (sandStart == Vec2l{x, y}) {
                 fmt::print("+");
             } else {
@@ -41,33 +47,51 @@ void printGrid(const auto &map) {
     }
 }
 
-Vec2l scanPoint(SimpleParser &scanner) {
-    const auto x = scanner.getInt64();
-    scanner.skipChar(',');
-    const auto y = scanner.getInt64();
-    return {x, y};
+// read all paths "498,4 -> 498,6 -> 496,6" into columns x, y and the
+// number of points per path
+void scanPaths(SimpleParser &scanner, auto &columns) {
+    std::vector<int64_t> coords{};
+    while (!scanner.isEof()) {
+        coords.clear();
+        scanner.getInt64s(coords, ",->");
+        for (size_t i = 0; i + 1 < coords.size(); i += 2) {
+            columns[0].push_back(coords[i]);
+            columns[1].push_back(coords[i + 1]);
+        }
+        columns[2].push_back(static_cast<int64_t>(coords.size() / 2));
+    }
 }
 
-void drawLine(auto &map, const Vec2l src, const Vec2l dst) {
+void drawLine(Cave &cave, const Vec2l src, const Vec2l dst) {
     const Vec2l dir = {signum(dst.x - src.x), signum(dst.y - src.y)};
     for (Vec2l pos = src; pos != dst; pos += dir) {
-        map[pos] = '#';
+        cave.blocked.insert(pos);
     }
-    map[dst] = '#';
+    cave.blocked.insert(dst);
+    cave.bounds.add(src);
+    cave.bounds.add(dst);
 }
 
 // drop one grain of sand and return true, if it falls below minY
-bool dropSand(auto &map, const auto maxY) {
-    constexpr std::array<Vec2l, 4> sandFalls{{{0, 1}, {-1, 1}, {1, 1}, {0, 0}}};
+bool dropSand(Cave &cave, const auto maxY) {
     auto sandPos = sandStart;
     do {
-        const auto fallTo =
-            sandPos +
-            *std::find_if(sandFalls.begin(), sandFalls.end(), [&](auto &dir) {
-                return !map.contains(sandPos + dir);
-            });
+        // bits 0..2 are the cells down left, down and down right
+        const auto below = cave.blocked.row(sandPos.y + 1, sandPos.x - 1);
+        // branches instead of a table lookup, the CPU can follow a grain
+        // falling straight down speculatively
+        auto fallTo = sandPos;
+        if ((below & 0b010) == 0) {
+            fallTo += Vec2l{0, 1};
+        } else if ((below & 0b001) == 0) {
+            fallTo += Vec2l{-1, 1};
+        } else if ((below & 0b100) == 0) {
+            fallTo += Vec2l{1, 1};
+        }
         if (fallTo == sandPos) {
-            map[sandPos] = 'o';
+            cave.blocked.insert(sandPos);
+            cave.sand.insert(sandPos);
+            cave.bounds.add(sandPos);
             return sandPos == sandStart;
         }
         sandPos = fallTo;
@@ -81,20 +105,23 @@ int main(int argc, char **argv) {
         std::exit(EXIT_FAILURE);
     }
 
-    std::unordered_map<Vec2l, char> cave;
-    // cave[sandStart] = '+';
+    Cave cave{};
     int64_t maxY = sandStart.y;
 
-    SimpleParser scanner{argv[1]};
-    while (!scanner.isEof()) {
-        Vec2l src = scanPoint(scanner);
+    const NumericColumns<3> paths{argv[1], [](SimpleParser &scanner, auto &columns) {
+        scanPaths(scanner, columns);
+    }};
+    size_t point = 0;
+    for (const auto pathLength : paths[2]) {
+        Vec2l src{paths[0][point], paths[1][point]};
         maxY = std::max(maxY, src.y);
-        while (scanner.skipToken("->")) {
-            Vec2l dst = scanPoint(scanner);
+        for (const auto i : iota(point + 1, point + pathLength)) {
+            const Vec2l dst{paths[0][i], paths[1][i]};
             maxY = std::max(maxY, dst.y);
             drawLine(cave, src, dst);
             src = dst;
         }
+        point += pathLength;
     }
     printGrid(cave);
     fmt::print("Maximum depth is {}\n", maxY);
@@ -2,14 +2,14 @@
 #include <fmt/format.h>
 #include <fstream>
 #include <iostream>
-#include <list>
 #include <ranges>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
+#include "intervalset.hpp"
+#include "sensors.hpp"
+#include "sidecar.hpp"
 #include "simpleparser.hpp"
-#include "utility.hpp"
 #include "vec2.hpp"
 
 using std::views::iota;
@@ -17,99 +17,38 @@ using std::views::iota;
 int64_t probeRow = 2000000;
 int64_t maxScan = 4000000;
 
-struct Sensor {
-    Vec2l position{};
-    Vec2l beacon{};
-    int64_t beaconDist{};
+Sensors deployed{};
 
-    Sensor(const Vec2l &position, const Vec2l &beacon)
-        : position(position), beacon(beacon),
-          beaconDist(manhattan(position, beacon)) {}
+// reused for every row, a row has only a few dozen ranges, inserting them
+// one by one is faster than sorting them as a batch
+IntervalSet scanned{};
 
-    std::pair<int64_t, int64_t> scanInRow(int64_t row) const {
-        const auto rowDist = std::abs(position.y - row);
-        if (rowDist > beaconDist) {
-            return {0, -1};
-        }
-        return {position.x - beaconDist + rowDist,
-                position.x + beaconDist - rowDist};
-    }
-};
-
-std::vector<Sensor> deployed{};
+void scanIntervals(const int64_t row) {
+    scanned.clear();
+    deployed.scanRow(row,
+                     [&](const int64_t from, const int64_t to) { scanned.insert(from, to); });
+}
 
 int64_t scanRow(int64_t row) {
-    std::unordered_set<int64_t> scanned{};
-    for (const auto &sensor : deployed) {
-        const auto [from, to] = sensor.scanInRow(row);
-        if (from <= to) {
-            for (const auto posX : iota(from, to + 1)) {
-                scanned.insert(posX);
-            }
-        }
-    }
-    for (const auto &sensor : deployed) {
-        if (sensor.beacon.y == row) {
-            scanned.erase(sensor.beacon.x);
+    scanIntervals(row);
+    std::vector<int64_t> beacons{};
+    for (const auto i : iota(0u, deployed.beacon.size())) {
+        if (deployed.beacon.y[i] == row) {
+            beacons.push_back(deployed.beacon.x[i]);
         }
     }
-    return scanned.size();
+    std::sort(beacons.begin(), beacons.end());
+    beacons.erase(std::unique(beacons.begin(), beacons.end()), beacons.end());
+    const auto covered =
+        std::ranges::count_if(beacons, [](const int64_t x) { return scanned.contains(x); });
+    return scanned.length() - covered;
 }
 
-struct Intervals {
-    std::list<std::pair<int64_t, int64_t>> intervals;
-
-    void insert(int64_t left, int64_t right) {
-        // fmt::print("insert [{}-{}] \n  into  ", left, right);
-        // print();
-        decltype(intervals) newIntervals{};
-        while (!intervals.empty()) {
-            if (right + 1 < intervals.front().first) {
-                // store it here
-                break;
-            } else if (left - 1 > intervals.front().second) {
-                // move over one interval
-                newIntervals.splice(newIntervals.end(), intervals,
-                                    intervals.begin());
-            } else {
-                // store overlap in [left, right]
-                left = std::min(left, intervals.front().first);
-                right = std::max(right, intervals.front().second);
-                intervals.pop_front();
-            }
-        }
-        intervals.emplace_front(left, right);
-        intervals.splice(intervals.begin(), newIntervals);
-        // fmt::print("\n  gives "); print(); fmt::print("\n\n");
-    }
-
-    // find an empty spot for 2022d15
-    int64_t spot() const {
-        if (intervals.size() > 1) {
-            return intervals.front().second + 1;
-        }
-        if (intervals.front().first == 1) {
-            return 0;
-        }
-        return intervals.back().second + 1;
-    }
-
-    void print() const {
-        for (const auto &[left, right] : intervals) {
-            fmt::print("[{}-{}] ", left, right);
-        }
-    }
-};
-
+// first x in [0, maxScan] no sensor reaches, maxScan + 1 if there is none
 int64_t scanEmptyRow(int64_t row) {
-    Intervals scanned;
-    for (const auto &sensor : deployed) {
-        const auto [from, to] = sensor.scanInRow(row);
-        if (from <= to and from <= maxScan and to >= 0) {
-            scanned.insert(std::max(from, 0l), std::min(to, maxScan));
-        }
-    }
-    return scanned.spot();
+    scanIntervals(row);
+    const auto gaps = scanned.gaps(0, maxScan);
+    return gaps.empty() ? maxScan + 1 : gaps.front().from;
 }
 
 int main(int argc, char **argv) {
@@ -124,18 +63,24 @@ int main(int argc, char **argv) {
         maxScan = 20;
     }
 
-    SimpleParser scanner{argv[1]};
-    while (!scanner.isEof()) {
-        scanner.skipToken("Sensor at x=");
-        const auto sx = scanner.getInt64();
-        scanner.skipToken(", y=");
-        const auto sy = scanner.getInt64();
-        scanner.skipToken(": closest beacon is at x=");
-        const auto bx = scanner.getInt64();
-        scanner.skipToken(", y=");
-        const auto by = scanner.getInt64();
-        deployed.emplace_back(Vec2l{sx, sy}, Vec2l{bx, by});
+    const NumericColumns<4> sensors{argv[1], [](SimpleParser &scanner, auto &columns) {
+        while (!scanner.isEof()) {
+            const auto sensor =
+                scanner.scan<"Sensor at x={}, y={}: closest beacon is at x={}, y={}">();
+            if (sensor) {
+                const auto [sx, sy, bx, by] = *sensor;
+                columns[0].push_back(sx);
+                columns[1].push_back(sy);
+                columns[2].push_back(bx);
+                columns[3].push_back(by);
+            }
+        }
+    }};
+    for (const auto i : iota(0u, sensors[0].size())) {
+        deployed.add(Vec2l{sensors[0][i], sensors[1][i]},
+                     Vec2l{sensors[2][i], sensors[3][i]});
     }
+    deployed.measure();
     fmt::print("There are {} spots on row {}\n", scanRow(probeRow), probeRow);
 
     for (const auto row2 : iota(0, maxScan + 1)) {
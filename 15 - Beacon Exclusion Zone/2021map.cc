@@ -8,8 +8,9 @@
 #include <unordered_set>
 #include <vector>
 
+#include "sensors.hpp"
+#include "sidecar.hpp"
 #include "simpleparser.hpp"
-#include "utility.hpp"
 #include "vec2.hpp"
 
 using std::views::iota;
@@ -17,40 +18,18 @@ using std::views::iota;
 int64_t probeRow = 2000000;
 int64_t maxScan = 4000000;
 
-struct Sensor {
-    Vec2l position{};
-    Vec2l beacon{};
-    int64_t beaconDist{};
-
-    Sensor(const Vec2l &position, const Vec2l &beacon)
-        : position(position), beacon(beacon),
-          beaconDist(manhattan(position, beacon)) {}
-
-    std::pair<int64_t, int64_t> scanInRow(int64_t row) const {
-        const auto rowDist = std::abs(position.y - row);
-        if (rowDist > beaconDist) {
-            return {0, -1};
-        }
-        return {position.x - beaconDist + rowDist,
-                position.x + beaconDist - rowDist};
-    }
-};
-
-std::vector<Sensor> deployed{};
+Sensors deployed{};
 
 int64_t scanRow(int64_t row) {
     std::unordered_set<int64_t> scanned{};
-    for (const auto &sensor : deployed) {
-        const auto [from, to] = sensor.scanInRow(row);
-        if (from <= to) {
-            for (const auto posX : iota(from, to + 1)) {
-                scanned.insert(posX);
-            }
+    deployed.scanRow(row, [&](const int64_t from, const int64_t to) {
+        for (const auto posX : iota(from, to + 1)) {
+            scanned.insert(posX);
         }
-    }
-    for (const auto &sensor : deployed) {
-        if (sensor.beacon.y == row) {
-            scanned.erase(sensor.beacon.x);
+    });
+    for (const auto i : iota(0u, deployed.beacon.size())) {
+        if (deployed.beacon.y[i] == row) {
+            scanned.erase(deployed.beacon.x[i]);
         }
     }
     return scanned.size();
@@ -113,12 +92,11 @@ struct Intervals {
 
 int64_t scanEmptyRow(int64_t row) {
     Intervals scanned;
-    for (const auto &sensor : deployed) {
-        const auto [from, to] = sensor.scanInRow(row);
-        if (from <= to and from <= maxScan and to >= 0) {
+    deployed.scanRow(row, [&](const int64_t from, const int64_t to) {
+        if (from <= maxScan and to >= 0) {
             scanned.insert(std::max(from, 0l), std::min(to, maxScan));
         }
-    }
+    });
     return scanned.spot();
 }
 
@@ -134,18 +112,24 @@ int main(int argc, char **argv) {
         maxScan = 20;
     }
 
-    SimpleParser scanner{argv[1]};
-    while (!scanner.isEof()) {
-        scanner.skipToken("Sensor at x=");
-        const auto sx = scanner.getInt64();
-        scanner.skipToken(", y=");
-        const auto sy = scanner.getInt64();
-        scanner.skipToken(": closest beacon is at x=");
-        const auto bx = scanner.getInt64();
-        scanner.skipToken(", y=");
-        const auto by = scanner.getInt64();
-        deployed.emplace_back(Vec2l{sx, sy}, Vec2l{bx, by});
+    const NumericColumns<4> sensors{argv[1], [](SimpleParser &scanner, auto &columns) {
+        while (!scanner.isEof()) {
+            const auto sensor =
+                scanner.scan<"Sensor at x={}, y={}: closest beacon is at x={}, y={}">();
+            if (sensor) {
+                const auto [sx, sy, bx, by] = *sensor;
+                columns[0].push_back(sx);
+                columns[1].push_back(sy);
+                columns[2].push_back(bx);
+                columns[3].push_back(by);
+            }
+        }
+    }};
+    for (const auto i : iota(0u, sensors[0].size())) {
+        deployed.add(Vec2l{sensors[0][i], sensors[1][i]},
+                     Vec2l{sensors[2][i], sensors[3][i]});
     }
+    deployed.measure();
     fmt::print("There are {} spots on row {}\n", scanRow(probeRow), probeRow);
 
     for (const auto row2 : iota(0, maxScan + 1)) {
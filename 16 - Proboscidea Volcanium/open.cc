@@ -2,7 +2,7 @@
 #include <fmt/format.h>
 #include <fstream>
 #include <iostream>
-#include <map>
+#include <limits>
 #include <ranges>
 #include <set>
 #include <sstream>
@@ -11,80 +11,78 @@
 #include <unordered_map>
 #include <vector>
 
+#include "allocationcounter.hpp"
 #include "simpleparser.hpp"
+#include "symboltable.hpp"
 
 using std::views::iota;
 
 struct Room {
-    std::string name;
-    std::vector<std::string> tunnels;
+    uint32_t id;
+    std::vector<uint32_t> tunnels;
     int64_t pressure;
-
-    // highest pressure first
-    auto operator<=>(const Room &other) {
-        if (other.pressure == pressure) {
-            return name <=> other.name;
-        }
-        return other.pressure <=> pressure;
-    }
 };
 
-std::unordered_map<std::string, Room> cave{};
-std::map<std::string, Room> pressurized{};
+SymbolTable valves{};
+// indexed by valve id
+std::vector<Room> cave{};
+std::vector<uint32_t> pressurized{};
 
-// initialized by fillFloydWarshall()
-std::map<std::pair<std::string, std::string>, int64_t> shortestPath{};
+// initialized by fillFloydWarshall(), noPath if there is no connection
+constexpr int64_t noPath = std::numeric_limits<int64_t>::max();
+std::vector<int64_t> shortestPath{};
+
+int64_t &pathLength(const uint32_t from, const uint32_t to) {
+    return shortestPath[from * cave.size() + to];
+}
 
 void fillFloydWarshall() {
     // https://en.wikipedia.org/wiki/Floyd%E2%80%93Warshall_algorithm
-    for (const auto &[u, room] : cave) {
-        for (const auto &v : room.tunnels) {
-            shortestPath[{u, v}] = 1;
+    const auto size = static_cast<uint32_t>(cave.size());
+    shortestPath.assign(cave.size() * cave.size(), noPath);
+    for (const auto &room : cave) {
+        for (const auto v : room.tunnels) {
+            pathLength(room.id, v) = 1;
         }
-        shortestPath[{u, u}] = 0;
+        pathLength(room.id, room.id) = 0;
     }
-    for (const auto &[k, _1] : cave) {
-        for (const auto &[i, _2] : cave) {
-            if (!shortestPath.contains({i, k})) {
+    for (const auto k : iota(0u, size)) {
+        for (const auto i : iota(0u, size)) {
+            if (pathLength(i, k) == noPath) {
                 continue;
             }
-            for (const auto &[j, _3] : cave) {
-                if (!shortestPath.contains({k, j})) {
+            for (const auto j : iota(0u, size)) {
+                if (pathLength(k, j) == noPath) {
                     continue;
                 }
-
-                if (shortestPath.contains({i, j})) {
-                    shortestPath[{i, j}] =
-                        std::min(shortestPath[{i, j}],
-                                 shortestPath[{i, k}] + shortestPath[{k, j}]);
-                } else {
-                    shortestPath[{i, j}] =
-                        shortestPath[{i, k}] + shortestPath[{k, j}];
-                }
+                pathLength(i, j) =
+                    std::min(pathLength(i, j), pathLength(i, k) + pathLength(k, j));
             }
         }
     }
-    fmt::print("Populated {} paths\n", shortestPath.size());
+    fmt::print("Populated {} paths\n",
+               std::ranges::count_if(shortestPath, [](auto len) { return len != noPath; }));
 }
 
 std::unordered_map<std::string, int64_t> memo{};
 
-int64_t findPathWithElephant(const int64_t minutes, const std::string &meRoom,
-                             const std::string &eleRoom, const int64_t meTime,
+int64_t findPathWithElephant(const int64_t minutes, const uint32_t meRoom,
+                             const uint32_t eleRoom, const int64_t meTime,
                              const int64_t eleTime,
-                             std::set<std::string> &valvesOpened) {
+                             std::set<uint32_t> &valvesOpened) {
+    ScopedTimer timer{"findPathWithElephant"};
     if (valvesOpened.size() == pressurized.size()) {
         return 0;
     }
 
     std::stringstream memoKey{};
     for (const auto &valve : valvesOpened) {
-        memoKey << valve;
+        memoKey << valve << ',';
     }
     if (meRoom < eleRoom) {
-        memoKey << meRoom << meTime << eleRoom << eleTime;
+        memoKey << meRoom << ':' << meTime << ':' << eleRoom << ':' << eleTime;
     } else {
-        memoKey << eleRoom << eleTime << meRoom << meTime;
+        memoKey << eleRoom << ':' << eleTime << ':' << meRoom << ':' << meTime;
     }
     if (memo.contains(memoKey.str())) {
         return memo[memoKey.str()];
@@ -92,24 +90,23 @@ int64_t findPathWithElephant(const int64_t minutes, const std::string &meRoom,
     // fmt::print("memoKey = {}\n",memoKey.str());
 
     int64_t pressure = 0;
-    for (const auto &[destName, destRoom] : pressurized) {
-        if (valvesOpened.contains(destName)) {
+    for (const auto dest : pressurized) {
+        if (valvesOpened.contains(dest)) {
             continue;
         }
-        const int64_t meReleaseTime =
-            meTime + shortestPath[{meRoom, destName}] + 1;
-        const int64_t eleReleaseTime =
-            eleTime + shortestPath[{eleRoom, destName}] + 1;
+        const auto &destRoom = cave[dest];
+        const int64_t meReleaseTime = meTime + pathLength(meRoom, dest) + 1;
+        const int64_t eleReleaseTime = eleTime + pathLength(eleRoom, dest) + 1;
         if (meReleaseTime <= eleReleaseTime) {
             // try me
             if (meReleaseTime <= minutes) {
                 const int64_t releasePressure =
                     destRoom.pressure * (minutes - meReleaseTime);
-                valvesOpened.insert(destName);
+                valvesOpened.insert(dest);
                 const auto mePressure =
-                    findPathWithElephant(minutes, destName, eleRoom,
+                    findPathWithElephant(minutes, dest, eleRoom,
                                          meReleaseTime, eleTime, valvesOpened);
-                valvesOpened.erase(destName);
+                valvesOpened.erase(dest);
 
                 pressure = std::max(pressure, releasePressure + mePressure);
             }
@@ -119,11 +116,11 @@ int64_t findPathWithElephant(const int64_t minutes, const std::string &meRoom,
             if (eleReleaseTime <= minutes) {
                 const int64_t releasePressure =
                     destRoom.pressure * (minutes - eleReleaseTime);
-                valvesOpened.insert(destName);
+                valvesOpened.insert(dest);
                 const auto elePressure =
-                    findPathWithElephant(minutes, meRoom, destName, meTime,
+                    findPathWithElephant(minutes, meRoom, dest, meTime,
                                          eleReleaseTime, valvesOpened);
-                valvesOpened.erase(destName);
+                valvesOpened.erase(dest);
 
                 pressure = std::max(pressure, releasePressure + elePressure);
             }
@@ -134,32 +131,32 @@ int64_t findPathWithElephant(const int64_t minutes, const std::string &meRoom,
     return pressure;
 }
 
-int64_t findPathWithElephant(const int64_t minutes, const std::string &meRoom,
-                             const std::string &eleRoom) {
-    std::set<std::string> valvesOpened{};
+int64_t findPathWithElephant(const int64_t minutes, const uint32_t meRoom,
+                             const uint32_t eleRoom) {
+    std::set<uint32_t> valvesOpened{};
     return findPathWithElephant(minutes, meRoom, eleRoom, 0, 0, valvesOpened);
 }
 
-int64_t findPath(const int64_t minutes, const std::string &roomName,
+int64_t findPath(const int64_t minutes, const uint32_t room,
                  const int64_t time = 0,
-                 std::set<std::string> valvesOpened = {}) {
+                 std::set<uint32_t> valvesOpened = {}) {
+    ScopedTimer timer{"findPath"};
     if (valvesOpened.size() == pressurized.size()) {
         return 0;
     }
     int64_t pressure = 0;
-    for (const auto &[destName, destRoom] : pressurized) {
-        if (valvesOpened.contains(destName)) {
+    for (const auto dest : pressurized) {
+        if (valvesOpened.contains(dest)) {
             continue;
         }
-        const int64_t releaseTime =
-            time + shortestPath[{roomName, destName}] + 1;
+        const int64_t releaseTime = time + pathLength(room, dest) + 1;
         if (releaseTime <= minutes) {
             const int64_t releasePressure =
-                destRoom.pressure * (minutes - releaseTime);
-            valvesOpened.insert(destName);
+                cave[dest].pressure * (minutes - releaseTime);
+            valvesOpened.insert(dest);
             const auto subPressure =
-                findPath(minutes, destName, releaseTime, valvesOpened);
-            valvesOpened.erase(destName);
+                findPath(minutes, dest, releaseTime, valvesOpened);
+            valvesOpened.erase(dest);
 
             pressure = std::max(pressure, releasePressure + subPressure);
         }
@@ -176,29 +173,32 @@ int main(int argc, char **argv) {
 
     SimpleParser scanner{argv[1]};
     while (!scanner.isEof()) {
-        scanner.skipToken("Valve");
-        const auto name = scanner.getToken();
-        scanner.skipToken("has flow rate=");
-        const auto pressure = scanner.getInt64();
+        const auto valve = scanner.scan<"Valve {s} has flow rate={}">();
+        if (!valve) {
+            continue;
+        }
+        const auto id = valves.intern(std::get<0>(*valve));
+        const auto pressure = std::get<1>(*valve);
         if (!scanner.skipToken("; tunnel leads to valve")) {
             scanner.skipToken("; tunnels lead to valves");
         }
         decltype(Room::tunnels) dst{};
         do {
-            dst.push_back(scanner.getToken(','));
+            dst.push_back(valves.intern(scanner.getTokenView(',')));
         } while (scanner.skipChar(','));
-        cave.emplace(name, Room{name, dst, pressure});
+        cave.resize(valves.size());
+        cave[id] = Room{id, dst, pressure};
         if (pressure > 0) {
-            pressurized.emplace(name, cave[name]);
+            pressurized.push_back(id);
         }
     }
-    // std::sort(pressurized.begin(), pressurized.end());
     fillFloydWarshall();
 
-    const auto releasedPressure = findPath(30, "AA");
+    const auto start = valves.intern("AA");
+    const auto releasedPressure = findPath(30, start);
     fmt::print("You can release a pressure of {}\n", releasedPressure);
 
-    const auto releasedTwo = findPathWithElephant(26, "AA", "AA");
+    const auto releasedTwo = findPathWithElephant(26, start, start);
     fmt::print("You and your elephant can release a pressure of {}\n",
                releasedTwo);
 }
@@ -1,13 +1,14 @@
 #include <algorithm>
+#include <array>
 #include <fmt/format.h>
 #include <fstream>
 #include <iostream>
 #include <ranges>
-#include <sstream>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "cycledetector.hpp"
+#include "profiler.hpp"
 #include "vec2.hpp"
 
 using std::views::iota;
@@ -96,6 +97,7 @@ struct Rock {
     }
 
     void drop() {
+        ScopedTimer timer{"Rock::drop"};
         if (canMove(pos + Vec2l{0, -1})) {
             pos += Vec2l{0, -1};
         } else {
@@ -191,12 +193,11 @@ int64_t level(std::string &input, int64_t rounds) {
     int64_t wallClock = 0;
     int64_t addTowerHeight = 0;
 
-    struct State {
-        int64_t rocks;
-        int64_t height;
-        int64_t clock;
-    };
-    std::unordered_map<std::string, State> loopDetect{};
+    // depth of the top of every column below the tower height, then the
+    // position and shape of the falling rock
+    using Key = std::array<int64_t, 10>;
+    // rocks, height, clock
+    CycleDetector<Key, 3> loopDetect{};
 
     while (fallenRocks < rounds) {
         auto rock = tower.spawnRock();
@@ -207,37 +208,32 @@ int64_t level(std::string &input, int64_t rounds) {
 
             // check for repeats
             if (wallClock % input.size() == 0) {
-                std::stringstream hash{};
-                for (const auto n : tower.topPos) {
+                Key key{};
+                for (const auto x : iota(0u, tower.topPos.size())) {
+                    const auto n = tower.topPos[x];
                     if (n != 0) {
-                        if (tower.height() - n > (int64_t)input.size()) {
-                            hash << "X:";
-                        } else {
-                            hash << tower.height() - n << ':';
-                        }
+                        // too deep to matter
+                        key[x] = tower.height() - n > (int64_t)input.size() ? -1
+                                                                            : tower.height() - n;
                     } else {
-                        hash << "-:";
+                        key[x] = -2;
                     }
                 }
-                hash << rock.pos.x << ':' << rock.pos.y - tower.height() << ':'
-                     << rock.shape;
-                if (!loopDetect.contains(hash.str())) {
-                    loopDetect[hash.str()] =
-                        State{fallenRocks, tower.height(), wallClock};
-                } else {
-                    // advance loop and game state here
-                    const auto &prev = loopDetect[hash.str()];
-                    State loopSize = {fallenRocks - prev.rocks,
-                                      tower.height() - prev.height,
-                                      wallClock - prev.clock};
-                    fmt::print("Loop detected over {} rocks, {} cycles!\n",
-                               loopSize.rocks, loopSize.clock);
-                    const int64_t loopsToGo =
-                        (rounds - fallenRocks - 1) / loopSize.rocks;
-                    // advance!
-                    fallenRocks += loopSize.rocks * loopsToGo;
-                    addTowerHeight = loopSize.height * loopsToGo;
-                    wallClock += loopSize.clock * loopsToGo;
+                key[7] = rock.pos.x;
+                key[8] = rock.pos.y - tower.height();
+                key[9] = rock.shape;
+                const auto loopSize =
+                    loopDetect.check(key, {fallenRocks, tower.height(), wallClock});
+                if (loopSize) {
+                    fmt::print("Loop detected over {} rocks, {} cycles!\n", (*loopSize)[0],
+                               (*loopSize)[2]);
+                    // advance loop and game state here, the current rock
+                    // has not fallen yet
+                    CycleDetect::Counters<3> state{fallenRocks, tower.height(), wallClock};
+                    CycleDetect::fastForward(state, *loopSize, rounds - 1);
+                    fallenRocks = state[0];
+                    addTowerHeight = state[1] - tower.height();
+                    wallClock = state[2];
                     // There may be other loops of the same height, forget them
                     loopDetect.clear();
                 }
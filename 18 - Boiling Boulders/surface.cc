@@ -3,83 +3,50 @@
 #include <fstream>
 #include <iostream>
 #include <ranges>
-#include <stack>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
+#include "profiler.hpp"
+#include "sidecar.hpp"
 #include "simpleparser.hpp"
 #include "vec3.hpp"
+#include "voxelgrid.hpp"
 
 using std::views::iota;
 
-std::vector<Vec3l> directions{{-1, 0, 0}, {1, 0, 0},  {0, -1, 0},
-                              {0, 1, 0},  {0, 0, -1}, {0, 0, 1}};
-
-std::unordered_set<Vec3l> lava{};
-std::unordered_set<Vec3l> water{};
-
-void flood(const Vec3l &min, const Vec3l &max) {
-    std::unordered_set<Vec3l> toFill{};
-    toFill.insert(min);
-    while (!toFill.empty()) {
-        auto it = toFill.begin();
-        const auto current = *it;
-        toFill.erase(it);
-        water.insert(current);
-        for (const auto &dir : directions) {
-            const auto next = current + dir;
-            if (!water.contains(next) and !lava.contains(next)) {
-                if (next.x >= min.x and next.y >= min.y and next.z >= min.z) {
-                    if (next.x <= max.x and next.y <= max.y and
-                        next.z <= max.z) {
-                        toFill.insert(next);
-                    }
-                }
-            }
-        }
-    }
-}
-
-void flood() {
-    const auto [min, max] = boundingBox(lava);
-    flood(min - Vec3l{1, 1, 1}, max + Vec3l{1, 1, 1});
-}
-
 int main(int argc, char **argv) {
     if (argc != 2) {
         std::cerr << "Usage: " << argv[0] << " <input.txt>\n";
         std::exit(EXIT_FAILURE);
     }
 
-    SimpleParser scanner{argv[1]};
-    while (!scanner.isEof()) {
-        const auto x = scanner.getInt64();
-        scanner.skipChar(',');
-        const auto y = scanner.getInt64();
-        scanner.skipChar(',');
-        const auto z = scanner.getInt64();
-        lava.emplace(x, y, z);
-    }
-    int64_t outer = 0;
-    for (const auto &drop : lava) {
-        for (const auto &dir : directions) {
-            if (!lava.contains(drop + dir)) {
-                ++outer;
-            }
+    const NumericColumns<3> cubes{argv[1], [](SimpleParser &scanner, auto &columns) {
+        while (!scanner.isEof()) {
+            columns[0].push_back(scanner.getInt64());
+            scanner.skipChar(',');
+            columns[1].push_back(scanner.getInt64());
+            scanner.skipChar(',');
+            columns[2].push_back(scanner.getInt64());
         }
+    }};
+    const auto [minX, maxX] = std::ranges::minmax(cubes[0]);
+    const auto [minY, maxY] = std::ranges::minmax(cubes[1]);
+    const auto [minZ, maxZ] = std::ranges::minmax(cubes[2]);
+    // the box reaches one voxel beyond the lava on every side, so the water
+    // can flow around it from a corner
+    VoxelGrid lava{Vec3l{minX, minY, minZ} - Vec3l{1, 1, 1},
+                   Vec3l{maxX, maxY, maxZ} + Vec3l{1, 1, 1}};
+    for (const auto i : iota(0u, cubes[0].size())) {
+        lava.set({cubes[0][i], cubes[1][i], cubes[2][i]});
     }
-    fmt::print("The outside is {} square units\n", outer);
 
-    flood();
-    outer = 0;
-    for (const auto &drop : lava) {
-        for (const auto &dir : directions) {
-            if (water.contains(drop + dir)) {
-                ++outer;
-            }
-        }
+    {
+        PerfRegion region{"surface"};
+        fmt::print("The outside is {} square units\n",
+                   6 * lava.count() - lava.facesTouching(lava));
     }
-    fmt::print("The reachable outside is {} square units\n", outer);
+
+    PerfRegion region{"flood"};
+    const auto water = lava.reachable(lava.min());
+    fmt::print("The reachable outside is {} square units\n", lava.facesTouching(water));
 }
@@ -9,6 +9,7 @@
 #include <thread>
 #include <vector>
 
+#include "profiler.hpp"
 #include "simpleparser.hpp"
 
 using std::views::iota;
@@ -101,6 +102,7 @@ std::vector<Blueprint> blueprints;
 int64_t geodeAmount(const Blueprint &print, int64_t minutesLeft, World world,
                     const Material buildingBot, int64_t &geodesMonitor,
                     std::array<bool, 4> robotSkipped) {
+    ScopedTimer timer{"geodeAmount"};
     // debug
     // std::cout << "World with " << minutesLeft << " minutes left:\n  building
     // "
@@ -170,6 +172,7 @@ int64_t geodeAmount(const Blueprint &print, int64_t minutes) {
 }
 
 int64_t qualityLevel(const Blueprint &print) {
+    ScopedTimer timer{"qualityLevel"};
     return geodeAmount(print, 24) * print.id;
 }
 
@@ -180,27 +183,20 @@ int main(int argc, char **argv) {
     }
 
     SimpleParser scanner{argv[1]};
+    // records read, good or bad, the id of a bad one is unknown
+    int64_t records = 0;
     while (!scanner.isEof()) {
-        auto v = scanner.skipToken("Blueprint");
-        const auto id = scanner.getInt64();
-        v |= scanner.skipToken(": Each ore robot costs");
-        const auto c0 = scanner.getInt64();
-        v |= scanner.skipToken("ore. Each clay robot costs");
-        const auto c1 = scanner.getInt64();
-        v |= scanner.skipToken("ore. Each obsidian robot costs");
-        const auto c2 = scanner.getInt64();
-        v |= scanner.skipToken("ore and");
-        const auto c3 = scanner.getInt64();
-        v |= scanner.skipToken("clay. Each geode robot costs");
-        const auto c4 = scanner.getInt64();
-        v |= scanner.skipToken("ore and");
-        const auto c5 = scanner.getInt64();
-        v |= scanner.skipToken("obsidian.");
-        if (v) {
+        ++records;
+        const auto blueprint = scanner.scan<
+            "Blueprint {}: Each ore robot costs {} ore. Each clay robot costs {} ore. "
+            "Each obsidian robot costs {} ore and {} clay. "
+            "Each geode robot costs {} ore and {} obsidian.">();
+        if (blueprint) {
+            const auto [id, c0, c1, c2, c3, c4, c5] = *blueprint;
             blueprints.emplace_back(
                 id, std::array<int64_t, 6>{c0, c1, c2, c3, c4, c5});
         } else {
-            fmt::print("Error: misformed blueprint {}\n", id);
+            fmt::print("Error: misformed blueprint, record {} of the input\n", records);
         }
     }
 
@@ -213,7 +209,10 @@ int main(int argc, char **argv) {
         if (i < (int64_t)blueprints.size()) {
             taskpool2.push_back(std::async(
                 std::launch::async,
-                [](const auto num) { return geodeAmount(blueprints[num], 32); },
+                [](const auto num) {
+                    ScopedTimer timer{"part 2 blueprint"};
+                    return geodeAmount(blueprints[num], 32);
+                },
                 i));
         }
     }
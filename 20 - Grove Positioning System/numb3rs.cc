@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 
+#include "sidecar.hpp"
 #include "simpleparser.hpp"
 
 using std::views::iota;
@@ -72,11 +73,15 @@ int main(int argc, char **argv) {
         DECRYPTION_KEY = std::stol(argv[2]);
     }
 
-    SimpleParser scanner{argv[1]};
+    const NumericColumns<1> numbers{argv[1], [](SimpleParser &scanner, auto &columns) {
+        while (!scanner.isEof()) {
+            columns[0].push_back(scanner.getInt64());
+        }
+    }};
     int64_t index = 0;
     int64_t zeroPos = 0;
-    while (!scanner.isEof()) {
-        data.push_back(scanner.getInt64() * DECRYPTION_KEY);
+    for (const auto number : numbers[0]) {
+        data.push_back(number * DECRYPTION_KEY);
         if (data.back() == 0) {
             zeroPos = index;
         }
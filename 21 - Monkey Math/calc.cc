@@ -2,19 +2,20 @@
 #include <fmt/format.h>
 #include <fstream>
 #include <iostream>
-#include <map>
+#include <optional>
 #include <ranges>
 #include <string>
 #include <vector>
 
 #include "simpleparser.hpp"
+#include "symboltable.hpp"
 
 using std::views::iota;
 
 struct Monkey {
     char op{};
-    std::string op1{};
-    std::string op2{};
+    uint32_t op1{};
+    uint32_t op2{};
     int64_t result{};
 
     void calculate(const Monkey &lhs, const Monkey &rhs) {
@@ -38,19 +39,32 @@ struct Monkey {
     Monkey &rcalc();
 };
 
+SymbolTable names{};
+
+// indexed by monkey id, empty if the monkey is not in that state
+using Monkeys = std::vector<std::optional<Monkey>>;
+
 // used for part 1
-std::map<std::string, Monkey> yells1{};
-std::map<std::string, Monkey> waits1{};
+Monkeys yells1{};
+Monkeys waits1{};
 
 // used for part 2
-std::map<std::string, Monkey> yells2{};
-std::map<std::string, Monkey> waits2{};
+Monkeys yells2{};
+Monkeys waits2{};
+
+uint32_t internMonkey(std::string_view name) {
+    const auto id = names.intern(name);
+    for (auto *monkeys : {&yells1, &waits1, &yells2, &waits2}) {
+        monkeys->resize(names.size());
+    }
+    return id;
+}
 
 // only used in part 2
 Monkey &Monkey::rcalc() {
-    if (yells2.contains(op2)) {
-        auto &mon1 = waits2[op1];
-        const auto &res2 = yells2[op2].result;
+    if (yells2[op2]) {
+        auto &mon1 = *waits2[op1];
+        const auto &res2 = yells2[op2]->result;
         switch (op) {
         case '+':
             mon1.result = result - res2;
@@ -69,8 +83,8 @@ Monkey &Monkey::rcalc() {
             return mon1;
         }
     } else {
-        auto &mon2 = waits2[op2];
-        const auto &res1 = yells2[op1].result;
+        auto &mon2 = *waits2[op2];
+        const auto &res1 = yells2[op1]->result;
         switch (op) {
         case '+':
             mon2.result = result - res1;
@@ -92,20 +106,26 @@ Monkey &Monkey::rcalc() {
     throw "not reached";
 }
 
-void yellingMonkeys(auto &yells, auto &waits) {
+void yellingMonkeys(Monkeys &yells, Monkeys &waits) {
+    std::vector<uint32_t> pending{};
+    for (const auto id : iota(0u, static_cast<uint32_t>(waits.size()))) {
+        if (waits[id]) {
+            pending.push_back(id);
+        }
+    }
     while (true) {
-        bool yelling = false;
-        for (auto it = waits.begin(); it != waits.end();) {
-            auto &[name, monkey] = *it;
-            ++it;
-            if (yells.contains(monkey.op1) and yells.contains(monkey.op2)) {
-                monkey.calculate(yells[monkey.op1], yells[monkey.op2]);
-                yells[name] = monkey;
-                waits.erase(name);
-                yelling = true;
+        const auto waiting = pending.size();
+        std::erase_if(pending, [&](const uint32_t id) {
+            auto &monkey = *waits[id];
+            if (yells[monkey.op1] and yells[monkey.op2]) {
+                monkey.calculate(*yells[monkey.op1], *yells[monkey.op2]);
+                yells[id] = monkey;
+                waits[id].reset();
+                return true;
             }
-        }
-        if (!yelling) {
+            return false;
+        });
+        if (pending.size() == waiting) {
             break;
         }
     }
@@ -119,37 +139,38 @@ int main(int argc, char **argv) {
 
     SimpleParser scanner{argv[1]};
     while (!scanner.isEof()) {
-        const auto name = scanner.getToken(':');
+        const auto name = internMonkey(scanner.getTokenView(':'));
         scanner.skipChar(':');
         if (std::isdigit(scanner.peekChar())) {
             Monkey monkey{};
             monkey.result = scanner.getInt64();
             yells1[name] = monkey;
-            if (name != "humn") {
-                yells2[name] = monkey;
-            }
+            yells2[name] = monkey;
         } else {
-            const auto op1 = scanner.getToken();
-            const auto op = scanner.getToken()[0];
-            const auto op2 = scanner.getToken();
+            const auto op1 = internMonkey(scanner.getTokenView());
+            const auto op = scanner.getTokenView()[0];
+            const auto op2 = internMonkey(scanner.getTokenView());
             waits1[name] = Monkey(op, op1, op2);
             waits2[name] = Monkey(op, op1, op2);
         }
     }
-    waits2["root"].op = '=';
+    const auto root = names.find("root");
+    const auto humnId = names.find("humn");
+    yells2[humnId].reset();
+    waits2[root]->op = '=';
 
     // part 1
     yellingMonkeys(yells1, waits1);
-    fmt::print("You hear a yell: {}\n", yells1["root"].result);
+    fmt::print("You hear a yell: {}\n", yells1[root]->result);
 
     // part 2
     yellingMonkeys(yells2, waits2);
     Monkey humn{};
     humn.op = 'x';
-    waits2["humn"] = humn;
-    Monkey &trace = waits2["root"];
+    waits2[humnId] = humn;
+    Monkey &trace = *waits2[root];
     while (!(trace.op == 'x')) {
         trace = trace.rcalc();
     }
-    fmt::print("You yell: {}\n", waits2["humn"].result);
+    fmt::print("You yell: {}\n", waits2[humnId]->result);
 }
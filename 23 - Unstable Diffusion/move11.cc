@@ -6,10 +6,14 @@
 #include <iostream>
 #include <ranges>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
+#include "boundingbox.hpp"
+#include "chunkedbitgrid2.hpp"
+#include "cycledetector.hpp"
+#include "flathash.hpp"
 #include "vec2.hpp"
+#include "vecarray.hpp"
 
 // ==== set to true for animation ====
 constexpr bool visualize = false;
@@ -32,81 +36,98 @@ constexpr std::array<std::array<Vec2l, 3>, 4> AnyOf{
 
 using namespace Dir;
 
-std::unordered_set<Vec2l> map{};
-std::unordered_set<Vec2l> moveDest{};
-std::unordered_set<Vec2l> moveBlocked{};
-
-struct Elf {
-    Vec2l pos{};
-    Vec2l moveTo{};
-
-    bool considerMoveDir(const Vec2l &dir, const Vec2l &adj1,
-                         const Vec2l &adj2) {
-        // fmt::print("{}.considerMoveDir({}, {}, {})\n", pos, dir, adj1, adj2);
-        if (!map.contains(pos + dir) and !map.contains(pos + adj1) and
-            !map.contains(pos + adj2)) {
-            // fmt::print("Moving {} in {}\n", pos, dir);
-            moveTo = pos + dir;
-            if (moveDest.contains(moveTo)) {
-                moveBlocked.insert(moveTo);
-            } else {
-                moveDest.insert(moveTo);
-            }
-            return true;
-        }
-        return false;
+ChunkedBitGrid2 map{};
+// bounds of map, rebuilt while the elves move
+BoundingBoxTracker<Vec2l> bounds{};
+ChunkedBitGrid2 moveDest{};
+ChunkedBitGrid2 moveBlocked{};
+
+// positions of the elves and where they want to go in this round,
+// both have the same size
+Vec2Array<int64_t> elves{};
+Vec2Array<int64_t> moveTo{};
+
+void considerMoveDir(const size_t elf, const Vec2l &dir) {
+    const auto pos = elves[elf];
+    // fmt::print("Moving {} in {}\n", pos, dir);
+    moveTo.set(elf, pos + dir);
+    if (!moveDest.insert(pos + dir)) {
+        moveBlocked.insert(pos + dir);
     }
+}
 
-    void considerMove(const int64_t step) {
-        bool foundElf = false;
-        // do nothing rule
-        moveTo = pos;
-        for (const auto dir : Dir::All) {
-            if (map.contains(pos + dir)) {
-                foundElf = true;
-            }
-        }
-        if (!foundElf) {
-            // fmt::print("not moving {}\n", pos);
+void considerMove(const size_t elf, const int64_t step) {
+    const auto pos = elves[elf];
+    // do nothing rule
+    moveTo.set(elf, pos);
+    // the 3x3 neighbourhood as bits 0..2 (west to east) of three rows
+    const auto above = map.row(pos.y - 1, pos.x - 1) & 0b111;
+    const auto beside = map.row(pos.y, pos.x - 1) & 0b101;
+    const auto below = map.row(pos.y + 1, pos.x - 1) & 0b111;
+    const auto around = above | beside | below;
+    if (around == 0) {
+        // fmt::print("not moving {}\n", pos);
+        return;
+    }
+    // free directions in the order of AnyOf: N, S, W, E
+    const std::array<bool, 4> free{above == 0, below == 0, (around & 0b001) == 0,
+                                   (around & 0b100) == 0};
+    for (const auto propos : iota(0, 4)) {
+        const auto direction = static_cast<size_t>((step + propos) % 4);
+        if (free[direction]) {
+            considerMoveDir(elf, AnyOf[direction][0]);
             return;
         }
-        for (const auto propos : iota(0, 4)) {
-            const auto &where = AnyOf[(step + propos) % 4];
-            if (considerMoveDir(where[0], where[1], where[2])) {
-                return;
-            }
-        }
     }
+}
 
-    bool move() {
-        bool moved = false;
-        if (!moveBlocked.contains(moveTo)) {
-            moved = (pos != moveTo);
-            pos = moveTo;
-        }
-        map.insert(pos);
-        return moved;
+bool move(const size_t elf) {
+    bool moved = false;
+    const auto target = moveTo[elf];
+    if (!moveBlocked.contains(target)) {
+        moved = (elves[elf] != target);
+        elves.set(elf, target);
     }
-};
-
-std::vector<Elf> elves{};
+    map.insert(elves[elf]);
+    bounds.add(elves[elf]);
+    return moved;
+}
 
 bool step(const int64_t no) {
     moveDest.clear();
     moveBlocked.clear();
-    for (auto &elf : elves) {
-        elf.considerMove(no);
+    for (const auto elf : iota(0u, elves.size())) {
+        considerMove(elf, no);
     }
     map.clear();
+    bounds.clear();
     bool moved = false;
-    for (auto &elf : elves) {
-        moved |= elf.move();
+    for (const auto elf : iota(0u, elves.size())) {
+        moved |= move(elf);
     }
     return moved;
 }
 
-void drawMap(auto &coords) {
-    auto [min, max] = boundingBox(coords);
+// Digest of the positions of all elves. Together with the direction to try
+// first they decide the next rounds, so a repeat means the elves would never
+// stand still. The direction order repeats every 4 rounds, so does any loop.
+using Arrangement = std::array<uint64_t, 2>;
+
+Arrangement arrangement() {
+    // two digests, summed over the elves so that they don't wait for each
+    // other, the elf number keeps the order
+    uint64_t a = 0;
+    uint64_t b = 0;
+    for (const auto elf : iota(0u, elves.size())) {
+        const auto h = FlatHash::hash(elves[elf]);
+        a += FlatHash::mix(h ^ elf);
+        b ^= h * (2 * elf + 1);
+    }
+    return {a, b};
+}
+
+void drawMap(const ChunkedBitGrid2 &coords, const BoundingBoxTracker<Vec2l> &box) {
+    auto [min, max] = boundingBox(box);
     // if constexpr (visualize)
     //     min = {-12 - 5, -13 - 5};
     for (const auto y : iota(min.y - 1, max.y + 2)) {
@@ -134,7 +155,7 @@ void startAnimFrame() { fmt::print("\x1b[H"); }
 void delayAnimation() { usleep(1000 * 1000 / 5); }
 void animateMap(auto &map) {
     startAnimFrame();
-    drawMap(map);
+    drawMap(map, bounds);
     delayAnimation();
 }
 
@@ -151,14 +172,16 @@ int main(int argc, char **argv) {
         for (const auto mapX : iota(0, (int64_t)line.size())) {
             if (line[mapX] == '#') {
                 // fmt::print("Found ({}, {})\n", mapX,mapY);
-                elves.emplace_back(Vec2l{mapX, mapY});
+                elves.push_back({mapX, mapY});
                 map.insert({mapX, mapY});
+                bounds.add({mapX, mapY});
             }
         }
         ++mapY;
     }
+    moveTo = elves;
     // fmt::print("== Initial State ==\n");
-    // drawMap(map);
+    // drawMap(map, bounds);
     if constexpr (visualize) {
         startAnimation();
         animateMap(map);
@@ -167,18 +190,29 @@ int main(int argc, char **argv) {
     for (const auto i : iota(0, 10)) {
         step(i);
         // fmt::print("== End of Round {} ==\n", i + 1);
-        // drawMap(map);
+        // drawMap(map, bounds);
         if constexpr (visualize)
             animateMap(map);
     }
-    const auto [min, max] = boundingBox(map);
+    const auto [min, max] = boundingBox(bounds);
     const auto tiles = (max.x - min.x + 1) * (max.y - min.y + 1) - elves.size();
+    fmt::print("The elves cover {} empty tiles after 10 rounds\n", tiles);
+    // counter: the round
+    CycleDetector<Arrangement, 1> repeats{};
     int64_t i = 10;
     while (step(i)) {
         if constexpr (visualize)
             animateMap(map);
         ++i;
+        // only rounds with the same direction order can repeat each other
+        if (i % 4 != 0) {
+            continue;
+        }
+        if (const auto period = repeats.check(arrangement(), {i})) {
+            fmt::print("The elves repeat every {} rounds after round {}\n", (*period)[0],
+                       i - (*period)[0]);
+            std::exit(EXIT_FAILURE);
+        }
     }
-    fmt::print("The elves cover {} empty tiles after 10 rounds\n", tiles);
     fmt::print("The elves stood still in round {}\n", i + 1);
 }
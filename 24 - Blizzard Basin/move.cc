@@ -3,12 +3,12 @@
 #include <fstream>
 #include <iostream>
 #include <numeric>
-#include <queue>
 #include <ranges>
 #include <string>
 #include <vector>
 
-#include "timeit.hpp"
+#include "graphsearch.hpp"
+#include "profiler.hpp"
 #include "utility.hpp"
 #include "vec2.hpp"
 
@@ -28,9 +28,9 @@ struct Plateau {
     std::vector<bool> blizzLeft{};
     std::vector<bool> blizzRight{};
 
-    // path finding
+    // path finding, by position and minute in the blizzard cycle
     int64_t blizzardCycle{0};
-    std::vector<bool> visited{};
+    GraphSearch::Visited visited{};
 
     int64_t pos2ind(const Vec2l &pos) const { return pos.y * width + pos.x; }
 
@@ -40,6 +40,7 @@ struct Plateau {
         blizzLeft.resize(width * height, false);
         blizzRight.resize(width * height, false);
         blizzardCycle = std::lcm(width, height);
+        visited.resize(width * height * blizzardCycle);
     }
 
     bool hasBDown(const Vec2l &pos, const int64_t minute) const {
@@ -149,104 +150,87 @@ struct Plateau {
         }
         const int64_t visPos =
             pos2ind(pos) + (min % blizzardCycle) * width * height;
-        bool result = !visited[visPos];
-        visited[visPos] = true;
-        return result;
+        return visited.insert(visPos);
     }
 
     // A*
     // move out, but not where we came in
     int64_t findPath(const Vec2l &startPos, const Vec2l &endPos,
                      int64_t startTime) {
-        // int64_t singleStepCount{0}; // for debugging
+        ScopedTimer timer{"findPath"};
         struct State {
             Vec2l pos;
             int64_t min;
         };
-        auto compareState = [&](const State &a, const State &b) -> bool {
-            const auto aScore = a.min + manhattan(a.pos, endPos);
-            const auto bScore = b.min + manhattan(b.pos, endPos);
-            return aScore > bScore;
-        };
-        std::priority_queue<State, std::vector<State>, decltype(compareState)>
-            frontier{compareState};
-        frontier.emplace(startPos, startTime);
         visited.clear();
-        visited.resize(width * height * blizzardCycle, false);
-        while (!frontier.empty()) {
-            const auto current = frontier.top();
-            frontier.pop();
-            /* // debug
-            ++singleStepCount;
-            if((singleStepCount % 1) == 0) {
-                fmt::print("A*: step {} queuesize {}\n", singleStepCount,
-            frontier.size()); print(current.pos, current.min);
-            } */
-            if (current.pos == startPos) {
-                // wait, but not forever
-                if (current.min + 1 - startTime < blizzardCycle) {
-                    frontier.emplace(current.pos, current.min + 1);
-                }
-            }
-            for (const auto &dir : direction) {
-                const auto nextPos = current.pos + dir;
-                if (nextPos == endPos) {
-                    return current.min + 1;
+        const auto arrival = GraphSearch::astar(
+            State{startPos, startTime},
+            [&](const State &current, auto emit) {
+                if (current.pos == startPos) {
+                    // wait, but not forever
+                    if (current.min + 1 - startTime < blizzardCycle) {
+                        emit(State{current.pos, current.min + 1}, 1);
+                    }
                 }
-                if (registerMove(nextPos, current.min + 1)) {
-                    frontier.emplace(nextPos, current.min + 1);
+                for (const auto &dir : direction) {
+                    const auto nextPos = current.pos + dir;
+                    if (nextPos == endPos or registerMove(nextPos, current.min + 1)) {
+                        emit(State{nextPos, current.min + 1}, 1);
+                    }
                 }
-            }
-        }
-        return -1; // not reached if path
+            },
+            [&](const State &state) { return manhattan(state.pos, endPos); },
+            [&](const State &state) { return state.pos == endPos; });
+        // the search counts the minutes from startTime
+        return arrival < 0 ? -1 : startTime + arrival;
     }
 };
 
 int main(int argc, char **argv) {
-    const auto startTime = timeNow();
-
     if (argc != 2) {
         std::cerr << "Usage: " << argv[0] << " <input.txt>\n";
         std::exit(EXIT_FAILURE);
     }
 
     Plateau plat{};
-    std::vector<std::string> winds{};
-
-    std::ifstream infile{argv[1]};
-    std::string line;
-    std::getline(infile, line);
-    plat.width = line.size() - 2;
-    plat.exitUp = {static_cast<int64_t>(line.find('.')) - 1, -1};
-    while (std::getline(infile, line)) {
-        if (line[1] == '#' or line[2] == '#') {
-            break;
+    {
+        ScopedTimer timer{"parse"};
+        std::vector<std::string> winds{};
+
+        std::ifstream infile{argv[1]};
+        std::string line;
+        std::getline(infile, line);
+        plat.width = line.size() - 2;
+        plat.exitUp = {static_cast<int64_t>(line.find('.')) - 1, -1};
+        while (std::getline(infile, line)) {
+            if (line[1] == '#' or line[2] == '#') {
+                break;
+            }
+            winds.push_back(line);
         }
-        winds.push_back(line);
-    }
-    plat.height = winds.size();
-    plat.exitDown = {static_cast<int64_t>(line.find('.')) - 1, plat.height};
-    plat.resize();
-    for (const auto y : iota(0, plat.height)) {
-        for (const auto x : iota(0, plat.width)) {
-            plat.setBlizzard({x, y}, winds[y][x + 1]);
+        plat.height = winds.size();
+        plat.exitDown = {static_cast<int64_t>(line.find('.')) - 1, plat.height};
+        plat.resize();
+        for (const auto y : iota(0, plat.height)) {
+            for (const auto x : iota(0, plat.width)) {
+                plat.setBlizzard({x, y}, winds[y][x + 1]);
+            }
         }
     }
-    const auto parse = timeNow();
-
-    const auto way1 = plat.findPath(plat.exitUp, plat.exitDown, 0);
-    fmt::print("Reached the exit after {} minutes\n", way1);
-    const auto part1 = timeNow();
-
-    fmt::print("But we need to go back and get the snacks!\n");
-    const auto way2 = plat.findPath(plat.exitDown, plat.exitUp, way1);
-    fmt::print("The snacks are still cold (minute {})\n", way2);
-    const auto way3 = plat.findPath(plat.exitUp, plat.exitDown, way2);
-    fmt::print("Now, that took {} minutes in the end\n\n", way3);
-    const auto part2 = timeNow();
-
-    fmt::print("Time for parsing: {:.4f} ms\n",
-               timeDiff(startTime, parse) * 1000);
-    fmt::print("Time for part 1: {:.4f} ms\n", timeDiff(parse, part1) * 1000);
-    fmt::print("Time for part 2: {:.4f} ms\n", timeDiff(part1, part2) * 1000);
+
+    int64_t way1 = 0;
+    {
+        ScopedTimer timer{"part 1"};
+        way1 = plat.findPath(plat.exitUp, plat.exitDown, 0);
+        fmt::print("Reached the exit after {} minutes\n", way1);
+    }
+
+    {
+        ScopedTimer timer{"part 2"};
+        fmt::print("But we need to go back and get the snacks!\n");
+        const auto way2 = plat.findPath(plat.exitDown, plat.exitUp, way1);
+        fmt::print("The snacks are still cold (minute {})\n", way2);
+        const auto way3 = plat.findPath(plat.exitUp, plat.exitDown, way2);
+        fmt::print("Now, that took {} minutes in the end\n\n", way3);
+    }
 }
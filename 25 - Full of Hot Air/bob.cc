@@ -1,16 +1,18 @@
 #include <array>
 #include <fmt/format.h>
 #include <fmt/ostream.h>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "parallelparse.hpp"
+
 struct SNAFU {
     int64_t value;
 
-    SNAFU(const std::string &from) {
+    SNAFU(std::string_view from) {
         int64_t base = 1;
         value = 0;
         // digit: DIGit ITerator
@@ -58,19 +60,33 @@ struct SNAFU {
 };
 template <> struct fmt::formatter<SNAFU> : ostream_formatter {};
 
+// The echo of a chunk is printed when the chunk is merged, so the merged
+// Sum only keeps the sum.
+struct Sum {
+    std::string output{};
+    SNAFU sum{0};
+};
+
+Sum sumChunk(std::string_view chunk) {
+    Sum chunkSum{};
+    forEachLine(chunk, [&](std::string_view line) {
+        const SNAFU number{line};
+        chunkSum.output += fmt::format("{}₅ = {}₁₀\n", line, number.value);
+        chunkSum.sum += number;
+    });
+    return chunkSum;
+}
+
 int main(int argc, char **argv) {
     if (argc != 2) {
         std::cerr << "Usage: " << argv[0] << " <input.txt>\n";
         std::exit(EXIT_FAILURE);
     }
 
-    std::ifstream infile{argv[1]};
-    std::string line;
-    SNAFU sum{0};
-    while (std::getline(infile, line)) {
-        const SNAFU number{line};
-        fmt::print("{}₅ = {}₁₀\n", line, number.value);
-        sum += number;
-    }
-    fmt::print("The sum is {}₁₀, or {}₅\n", sum.value, sum);
+    const auto sum =
+        parallelParse(argv[1], Records::lines, sumChunk, [](Sum &total, Sum &&chunkSum) {
+            fmt::print("{}", chunkSum.output);
+            total.sum += chunkSum.sum;
+        }).sum;
+    std::cout << fmt::format("The sum is {}₁₀, or ", sum.value) << sum << "₅\n";
 }
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <fmt/format.h>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "timeit.hpp"
+
+// Best of several runs, shared by the benchmarks of this directory.
+// usage:
+// measure("name", 3, [&] { return work(); });
+//   - prints "  name   12.34 ms  (checksum <result of work()>)"
+// measure("name", 5, run, [](const std::string &name, double seconds, const auto &result) {
+//     return fmt::format(...);
+// });
+//   - prints the line format returns for the fastest run and its result
+// Both return the result of the fastest run.
+
+template <typename Run, typename Format>
+auto measure(const std::string &name, const int64_t runs, Run run, Format format) {
+    std::invoke_result_t<Run &> result{};
+    double best = 0;
+    for (int64_t i = 0; i < runs; ++i) {
+        const auto start = timeNow();
+        auto current = run();
+        const auto seconds = timeDiff(start, timeNow());
+        if (i == 0 or seconds < best) {
+            best = seconds;
+            result = std::move(current);
+        }
+    }
+    fmt::print("{}\n", format(name, best, result));
+    return result;
+}
+
+template <typename Run> auto measure(const std::string &name, const int64_t runs, Run run) {
+    const auto checksum = [](const std::string &label, const double seconds, const auto &sum) {
+        return fmt::format("  {:20s} {:10.2f} ms  (checksum {})", label, seconds * 1000., sum);
+    };
+    return measure(name, runs, run, checksum);
+}
@@ -0,0 +1,67 @@
+#include <fmt/format.h>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchutil.hpp"
+#include "boundingbox.hpp"
+#include "vec2.hpp"
+#include "vec3.hpp"
+#include "vecarray.hpp"
+
+// Bounding boxes of random points: the element by element loop of vec2.hpp /
+// vec3.hpp, the vectorized overloads for std::vector and BoundingBoxTracker
+// fed one point at a time.
+
+// same loop as boundingBox() in vec2.hpp / vec3.hpp, which a std::vector
+// doesn't reach anymore
+template <typename Vec> std::pair<Vec, Vec> scalarBox(const std::vector<Vec> &points) {
+    auto min = points[0];
+    auto max = points[0];
+    for (const auto &point : points) {
+        min = Bounds::lower(min, point);
+        max = Bounds::upper(max, point);
+    }
+    return {min, max};
+}
+
+template <typename Vec> std::pair<Vec, Vec> trackedBox(const std::vector<Vec> &points) {
+    BoundingBoxTracker<Vec> bounds{};
+    for (const auto &point : points) {
+        bounds.add(point);
+    }
+    return bounds.box();
+}
+
+int main(int argc, char **argv) {
+    const int64_t count = (argc > 1) ? std::stol(argv[1]) : 10'000'000;
+    if (count <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [points]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::mt19937_64 rng{2022};
+    std::uniform_int_distribution<int64_t> coord{-1'000'000, 1'000'000};
+    std::vector<Vec2l> points2(static_cast<size_t>(count));
+    for (auto &point : points2) {
+        point = {coord(rng), coord(rng)};
+    }
+    std::vector<Vec3l> points3(static_cast<size_t>(count));
+    for (auto &point : points3) {
+        point = {coord(rng), coord(rng), coord(rng)};
+    }
+    fmt::print("{} points (best of 5):\n", count);
+    const auto extent = [](const std::string &name, const double seconds, const auto &box) {
+        const auto &[min, max] = box;
+        return fmt::format("  {:20s} {:10.2f} ms  (checksum {})", name, seconds * 1000.,
+                           max.x - min.x + max.y - min.y);
+    };
+
+    measure("Vec2l scalar", 5, [&] { return scalarBox(points2); }, extent);
+    measure("Vec2l tracker", 5, [&] { return trackedBox(points2); }, extent);
+    measure("Vec2l vectorized", 5, [&] { return boundingBox(points2); }, extent);
+    measure("Vec3l scalar", 5, [&] { return scalarBox(points3); }, extent);
+    measure("Vec3l tracker", 5, [&] { return trackedBox(points3); }, extent);
+    measure("Vec3l vectorized", 5, [&] { return boundingBox(points3); }, extent);
+}
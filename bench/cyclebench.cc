@@ -0,0 +1,72 @@
+#include <array>
+#include <fmt/format.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "benchutil.hpp"
+#include "cycledetector.hpp"
+
+// Finding the cycle of x -> x * x + c mod m, which runs into a loop after
+// about sqrt(m) steps: string keys in an unordered_map like day 17 used to
+// do, CycleDetector with binary keys, and Brent's and Floyd's O(1) memory
+// searches.
+
+using State = std::array<uint64_t, 2>;
+
+struct Sequence {
+    uint64_t modulus;
+    uint64_t add;
+
+    // the second word just remembers a bit of the previous first word, to
+    // have keys of more than one number like the puzzles
+    State operator()(const State &state) const {
+        return {(state[0] * state[0] + add) % modulus, state[0] % 7};
+    }
+};
+
+CycleDetect::Cycle stringKeys(const Sequence &next, State state) {
+    std::unordered_map<std::string, int64_t> seen{};
+    for (int64_t step = 0;; ++step) {
+        std::stringstream key{};
+        key << state[0] << ':' << state[1];
+        const auto [entry, inserted] = seen.try_emplace(key.str(), step);
+        if (!inserted) {
+            return {entry->second, step - entry->second};
+        }
+        state = next(state);
+    }
+}
+
+CycleDetect::Cycle binaryKeys(const Sequence &next, State state) {
+    CycleDetector<State, 1> seen{};
+    for (int64_t step = 0;; ++step) {
+        if (const auto cycle = seen.check(state, {step})) {
+            return {step - (*cycle)[0], (*cycle)[0]};
+        }
+        state = next(state);
+    }
+}
+
+std::string line(const std::string &name, const double seconds, const CycleDetect::Cycle &cycle) {
+    return fmt::format("  {:20s} {:10.2f} ms  (start {}, length {})", name, seconds * 1000.,
+                       cycle.start, cycle.length);
+}
+
+int main(int argc, char **argv) {
+    const int64_t modulus = (argc > 1) ? std::stol(argv[1]) : 4'000'000'007;
+    // the square has to fit into 64 bits
+    if (modulus <= 1 or modulus > 4'000'000'007) {
+        std::cerr << "Usage: " << argv[0] << " [modulus]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const Sequence next{static_cast<uint64_t>(modulus), 1};
+    const State first{2, 0};
+    fmt::print("x -> x * x + 1 mod {} from 2 (best of 3):\n", modulus);
+    measure("string keys", 3, [&] { return stringKeys(next, first); }, line);
+    measure("CycleDetector", 3, [&] { return binaryKeys(next, first); }, line);
+    measure("Brent", 3, [&] { return CycleDetect::brent(first, next); }, line);
+    measure("Floyd", 3, [&] { return CycleDetect::floyd(first, next); }, line);
+}
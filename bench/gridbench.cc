@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchutil.hpp"
+#include "grid2d.hpp"
+#include "scanlocations.hpp"
+#include "vec2.hpp"
+
+// Compare std::vector<std::string> grids with Grid2D on generated maps:
+// loading, the day 8 visibility check (also with GridRay and castLine of
+// scanlocations.hpp) and a day 12 style breadth first search.
+
+const std::vector<Vec2l> directions = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+void generateTrees(const std::filesystem::path &filename, const int64_t size) {
+    std::ofstream out{filename};
+    std::mt19937_64 rng{2022};
+    std::uniform_int_distribution<int> tree{'0', '9'};
+    std::string line(static_cast<size_t>(size), ' ');
+    for (int64_t y = 0; y < size; ++y) {
+        for (auto &c : line) {
+            c = static_cast<char>(tree(rng));
+        }
+        out << line << '\n';
+    }
+}
+
+// slopes of 'a'..'z' with some noise, climbable in most places
+void generateHills(const std::filesystem::path &filename, const int64_t size) {
+    std::ofstream out{filename};
+    std::mt19937_64 rng{2022};
+    std::uniform_int_distribution<int> noise{0, 2};
+    std::string line(static_cast<size_t>(size), ' ');
+    for (int64_t y = 0; y < size; ++y) {
+        for (int64_t x = 0; x < size; ++x) {
+            line[static_cast<size_t>(x)] =
+                static_cast<char>('a' + ((x + y) * 24 / (2 * size) + noise(rng)));
+        }
+        out << line << '\n';
+    }
+}
+
+// heights rising towards the center, every tree is visible from all sides
+Grid2D<int32_t> pyramid(const int64_t size) {
+    Grid2D<int32_t> field{{static_cast<size_t>(size), static_cast<size_t>(size)}};
+    for (int64_t y = 0; y < size; ++y) {
+        for (int64_t x = 0; x < size; ++x) {
+            field[Vec2l{x, y}] = static_cast<int32_t>(
+                std::min(std::min(x, size - 1 - x), std::min(y, size - 1 - y)));
+        }
+    }
+    return field;
+}
+
+std::vector<std::string> loadStrings(const char *filename) {
+    std::ifstream infile{filename};
+    std::vector<std::string> field{};
+    std::string line{};
+    while (std::getline(infile, line)) {
+        field.push_back(line);
+    }
+    return field;
+}
+
+int64_t visibleStrings(const std::vector<std::string> &field) {
+    const auto height = static_cast<int64_t>(field.size());
+    const auto width = static_cast<int64_t>(field[0].size());
+    const Vec2l limit{width - 1, height - 1};
+    int64_t visible = 0;
+    for (int64_t y = 0; y < height; ++y) {
+        for (int64_t x = 0; x < width; ++x) {
+            const auto tree = field[static_cast<size_t>(y)][static_cast<size_t>(x)];
+            for (const auto &direction : directions) {
+                bool seen = true;
+                for (const auto look :
+                     ScanLocations(Vec2l{x, y} + direction, direction, {0, 0}, limit)) {
+                    if (field[static_cast<size_t>(look.y)][static_cast<size_t>(look.x)] >= tree) {
+                        seen = false;
+                        break;
+                    }
+                }
+                if (seen) {
+                    ++visible;
+                    break;
+                }
+            }
+        }
+    }
+    return visible;
+}
+
+template <typename T> int64_t visibleGrid(const Grid2D<T> &field) {
+    const Vec2l limit{field.width() - 1, field.height() - 1};
+    int64_t visible = 0;
+    for (int64_t y = 0; y < field.height(); ++y) {
+        for (int64_t x = 0; x < field.width(); ++x) {
+            const auto tree = field[Vec2l{x, y}];
+            for (const auto &direction : directions) {
+                bool seen = true;
+                for (const auto look :
+                     ScanLocations(Vec2l{x, y} + direction, direction, {0, 0}, limit)) {
+                    if (field[look] >= tree) {
+                        seen = false;
+                        break;
+                    }
+                }
+                if (seen) {
+                    ++visible;
+                    break;
+                }
+            }
+        }
+    }
+    return visible;
+}
+
+template <typename T> int64_t visibleGridRay(const Grid2D<T> &field) {
+    int64_t visible = 0;
+    for (int64_t y = 0; y < field.height(); ++y) {
+        for (int64_t x = 0; x < field.width(); ++x) {
+            const auto tree = field[Vec2l{x, y}];
+            for (const auto &direction : directions) {
+                const GridRay ray{field, {x, y}, direction};
+                if (ray.find([&](const T look) { return look >= tree; }) == ray.size()) {
+                    ++visible;
+                    break;
+                }
+            }
+        }
+    }
+    return visible;
+}
+
+// all rays of every row and column at once
+template <typename T> int64_t visibleCastLine(const Grid2D<T> &field) {
+    Grid2D<uint8_t> seen{field.size()};
+    for (const auto &direction : directions) {
+        const auto lines = direction.x != 0 ? field.height() : field.width();
+        for (int64_t line = 0; line < lines; ++line) {
+            const auto stops = castLine(field, line, direction);
+            for (size_t i = 0; i < stops.size(); ++i) {
+                if (!stops[i].blocked) {
+                    const auto at = static_cast<int64_t>(i);
+                    seen[direction.x != 0 ? Vec2l{at, line} : Vec2l{line, at}] = 1;
+                }
+            }
+        }
+    }
+    int64_t visible = 0;
+    for (int64_t y = 0; y < field.height(); ++y) {
+        for (int64_t x = 0; x < field.width(); ++x) {
+            visible += seen[Vec2l{x, y}];
+        }
+    }
+    return visible;
+}
+
+// sum of the distances of all reachable squares from the top left corner
+int64_t hikeStrings(const std::vector<std::string> &heightmap) {
+    const auto height = static_cast<int64_t>(heightmap.size());
+    const auto width = static_cast<int64_t>(heightmap[0].size());
+    std::vector<std::vector<int64_t>> distmap(static_cast<size_t>(height),
+                                              std::vector<int64_t>(static_cast<size_t>(width), -1));
+    const auto at = [](auto &rows, const Vec2l pos) -> auto & {
+        return rows[static_cast<size_t>(pos.y)][static_cast<size_t>(pos.x)];
+    };
+    std::vector<Vec2l> frontier{{0, 0}};
+    at(distmap, {0, 0}) = 0;
+    int64_t total = 0;
+    for (int64_t step = 1; !frontier.empty(); ++step) {
+        std::vector<Vec2l> next{};
+        for (const auto pos : frontier) {
+            for (const auto &direction : directions) {
+                const auto dst = pos + direction;
+                if (dst.x < 0 or dst.y < 0 or dst.x >= width or dst.y >= height) {
+                    continue;
+                }
+                if (at(distmap, dst) == -1 and at(heightmap, dst) <= at(heightmap, pos) + 1) {
+                    at(distmap, dst) = step;
+                    total += step;
+                    next.push_back(dst);
+                }
+            }
+        }
+        frontier.swap(next);
+    }
+    return total;
+}
+
+int64_t hikeGrid(const Grid2D<char> &heightmap) {
+    Grid2D<int64_t> distmap{heightmap.size(), -1, 1, -2};
+    std::vector<Vec2l> frontier{{0, 0}};
+    distmap[Vec2l{0, 0}] = 0;
+    int64_t total = 0;
+    for (int64_t step = 1; !frontier.empty(); ++step) {
+        std::vector<Vec2l> next{};
+        for (const auto pos : frontier) {
+            for (const auto &direction : directions) {
+                // the border is never unvisited, no bounds check needed
+                const auto dst = pos + direction;
+                if (distmap[dst] == -1 and heightmap[dst] <= heightmap[pos] + 1) {
+                    distmap[dst] = step;
+                    total += step;
+                    next.push_back(dst);
+                }
+            }
+        }
+        frontier.swap(next);
+    }
+    return total;
+}
+
+int main(int argc, char **argv) {
+    const int64_t size = (argc > 1) ? std::stol(argv[1]) : 5000;
+    if (size <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [map size]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const auto trees = std::filesystem::temp_directory_path() / "gridbench-trees.txt";
+    const auto hills = std::filesystem::temp_directory_path() / "gridbench-hills.txt";
+    generateTrees(trees, size);
+    generateHills(hills, size);
+    fmt::print("{0}x{0} maps (best of 3):\n", size);
+
+    measure("load strings", 3,
+            [&] { return static_cast<int64_t>(loadStrings(trees.c_str()).size()); });
+    measure("load Grid2D", 3, [&] { return loadGrid(trees.c_str()).height(); });
+
+    const auto treeStrings = loadStrings(trees.c_str());
+    const auto treeGrid = loadGrid(trees.c_str());
+    measure("visible strings", 3, [&] { return visibleStrings(treeStrings); });
+    measure("visible Grid2D", 3, [&] { return visibleGrid(treeGrid); });
+    measure("visible GridRay", 3, [&] { return visibleGridRay(treeGrid); });
+    measure("visible castLine", 3, [&] { return visibleCastLine(treeGrid); });
+
+    const auto hillStrings = loadStrings(hills.c_str());
+    const auto hillGrid = loadGrid(hills.c_str(), 1, '\x7f');
+    // every ray runs down to the edge, castLine stays linear per line
+    const auto peak = pyramid(size / 4);
+    measure("pyramid Grid2D", 3, [&] { return visibleGrid(peak); });
+    measure("pyramid GridRay", 3, [&] { return visibleGridRay(peak); });
+    measure("pyramid castLine", 3, [&] { return visibleCastLine(peak); });
+
+    measure("hike strings", 3, [&] { return hikeStrings(hillStrings); });
+    measure("hike Grid2D", 3, [&] { return hikeGrid(hillGrid); });
+
+    std::filesystem::remove(trees);
+    std::filesystem::remove(hills);
+}
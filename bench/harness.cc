@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "timeit.hpp"
+
+// Runs a solver a number of times after some warm-up runs and reports the
+// min, median and 95th percentile of the wall clock time. The results are
+// kept in a baseline file keyed by git commit. A median more than the
+// threshold above the baseline fails, the baseline is the entry of HEAD if
+// there is one, otherwise the last commit in the file. Results are only
+// stored for a clean worktree without an entry yet, or with -u. Timings
+// only compare on the same machine, so the baseline files are not
+// committed, .gitignore lists bench.json.
+// make bench in a day directory runs this for every program of the day.
+
+struct Stats {
+    int64_t runs{};
+    double min{};
+    double median{};
+    double p95{};
+};
+
+// commit -> program -> stats, in the order they were recorded
+using Programs = std::vector<std::pair<std::string, Stats>>;
+using Baselines = std::vector<std::pair<std::string, Programs>>;
+
+// just enough JSON for the baseline file, objects of objects of numbers
+class JsonReader {
+    std::string text;
+    size_t pos{0};
+
+    void fail() const {
+        throw std::runtime_error(fmt::format("malformed baseline file at offset {}", pos));
+    }
+
+    void skipSpace() {
+        while (pos < text.size() and std::isspace(static_cast<unsigned char>(text[pos]))) {
+            ++pos;
+        }
+    }
+
+  public:
+    explicit JsonReader(std::string content) : text(std::move(content)) {}
+
+    bool consume(const char c) {
+        skipSpace();
+        if (pos < text.size() and text[pos] == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(const char c) {
+        if (!consume(c)) {
+            fail();
+        }
+    }
+
+    // no escapes, commits and program names don't need them
+    std::string string() {
+        expect('"');
+        const auto end = text.find('"', pos);
+        if (end == std::string::npos) {
+            fail();
+        }
+        auto value = text.substr(pos, end - pos);
+        pos = end + 1;
+        return value;
+    }
+
+    double number() {
+        skipSpace();
+        size_t used = 0;
+        const auto value = std::stod(text.substr(pos, 32), &used);
+        pos += used;
+        return value;
+    }
+
+    // member(key) reads the value of every key
+    void object(auto member) {
+        expect('{');
+        if (consume('}')) {
+            return;
+        }
+        do {
+            const auto key = string();
+            expect(':');
+            member(key);
+        } while (consume(','));
+        expect('}');
+    }
+};
+
+Baselines readBaselines(const std::filesystem::path &path) {
+    Baselines baselines{};
+    std::ifstream infile{path};
+    if (!infile) {
+        return baselines;
+    }
+    JsonReader json{{std::istreambuf_iterator<char>{infile}, {}}};
+    json.object([&](const std::string &commit) {
+        auto &programs = baselines.emplace_back(commit, Programs{}).second;
+        json.object([&](const std::string &program) {
+            auto &stats = programs.emplace_back(program, Stats{}).second;
+            json.object([&](const std::string &field) {
+                const auto value = json.number();
+                if (field == "runs") {
+                    stats.runs = static_cast<int64_t>(value);
+                } else if (field == "min") {
+                    stats.min = value;
+                } else if (field == "median") {
+                    stats.median = value;
+                } else if (field == "p95") {
+                    stats.p95 = value;
+                }
+            });
+        });
+    });
+    return baselines;
+}
+
+void writeBaselines(const std::filesystem::path &path, const Baselines &baselines) {
+    std::ofstream out{path};
+    out << "{";
+    for (size_t c = 0; c < baselines.size(); ++c) {
+        const auto &[commit, programs] = baselines[c];
+        out << (c == 0 ? "\n" : ",\n") << fmt::format("  \"{}\": {{", commit);
+        for (size_t p = 0; p < programs.size(); ++p) {
+            const auto &[program, stats] = programs[p];
+            out << (p == 0 ? "\n" : ",\n")
+                << fmt::format(R"(    "{}": {{"runs": {}, "min": {:.6f}, "median": {:.6f}, )"
+                               R"("p95": {:.6f}}})",
+                               program, stats.runs, stats.min, stats.median, stats.p95);
+        }
+        out << "\n  }";
+    }
+    out << "\n}\n";
+}
+
+// first line of the output of command, empty if it fails
+std::string firstLine(const char *command) {
+    std::string line{};
+    if (auto *pipe = popen(command, "r")) {
+        char buffer[256];
+        if (std::fgets(buffer, sizeof(buffer), pipe)) {
+            line = buffer;
+        }
+        pclose(pipe);
+    }
+    while (!line.empty() and std::isspace(static_cast<unsigned char>(line.back()))) {
+        line.pop_back();
+    }
+    return line;
+}
+
+// seconds for one run of command with its output thrown away
+double runOnce(char **command) {
+    const auto start = timeNow();
+    const auto child = fork();
+    if (child == 0) {
+        const auto null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        dup2(null, STDERR_FILENO);
+        execvp(command[0], command);
+        _exit(127);
+    }
+    int status = 0;
+    if (child < 0 or waitpid(child, &status, 0) < 0 or !WIFEXITED(status) or
+        WEXITSTATUS(status) != 0) {
+        throw std::runtime_error(fmt::format("{} failed", command[0]));
+    }
+    return timeDiff(start, timeNow());
+}
+
+Stats measure(char **command, const int64_t runs, const int64_t warmup) {
+    for (int64_t i = 0; i < warmup; ++i) {
+        runOnce(command);
+    }
+    std::vector<double> times{};
+    for (int64_t i = 0; i < runs; ++i) {
+        times.push_back(runOnce(command));
+    }
+    std::ranges::sort(times);
+    const auto n = times.size();
+    const auto median = n % 2 == 1 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2;
+    const auto p95 = times[static_cast<size_t>(std::ceil(0.95 * double(n))) - 1];
+    return {runs, times.front(), median, p95};
+}
+
+int main(int argc, char **argv) {
+    int64_t runs = 10;
+    int64_t warmup = 2;
+    double threshold = 10;
+    std::filesystem::path baselineFile{"bench.json"};
+    bool update = false;
+
+    int arg = 1;
+    for (; arg + 1 < argc and argv[arg][0] == '-'; ++arg) {
+        const std::string option{argv[arg]};
+        if (option == "-u") {
+            update = true;
+        } else if (option == "-n") {
+            runs = std::stol(argv[++arg]);
+        } else if (option == "-w") {
+            warmup = std::stol(argv[++arg]);
+        } else if (option == "-t") {
+            threshold = std::stod(argv[++arg]);
+        } else if (option == "-b") {
+            baselineFile = argv[++arg];
+        } else {
+            break;
+        }
+    }
+    if (arg + 2 >= argc or std::string{argv[arg + 1]} != "--" or runs <= 0 or warmup < 0) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [-n runs] [-w warmup runs] [-t threshold %] [-b baseline.json] [-u]"
+                     " <name> -- <command> [args]...\n";
+        std::exit(EXIT_FAILURE);
+    }
+    const std::string name{argv[arg]};
+    char **command = argv + arg + 2;
+
+    try {
+        const auto stats = measure(command, runs, warmup);
+        fmt::print("{}: min {:.3f} ms, median {:.3f} ms, p95 {:.3f} ms ({} runs)\n", name,
+                   stats.min * 1000., stats.median * 1000., stats.p95 * 1000., stats.runs);
+
+        const auto commit = firstLine("git rev-parse --short HEAD 2>/dev/null");
+        const bool dirty =
+            !firstLine("git status --porcelain --untracked-files=no 2>/dev/null").empty();
+        auto baselines = readBaselines(baselineFile);
+        auto current = std::ranges::find(baselines, commit, &Baselines::value_type::first);
+
+        bool regressed = false;
+        if (!baselines.empty()) {
+            const auto &[reference, programs] =
+                current != baselines.end() ? *current : baselines.back();
+            const auto entry = std::ranges::find(programs, name, &Programs::value_type::first);
+            if (entry != programs.end()) {
+                const auto change = (stats.median / entry->second.median - 1) * 100.;
+                regressed = change > threshold;
+                fmt::print("  baseline {}: median {:.3f} ms, {:+.1f}%{}\n", reference,
+                           entry->second.median * 1000., change,
+                           regressed ? fmt::format(", regression over {}%", threshold) : "");
+            }
+        }
+
+        if (!commit.empty() and (update or !dirty)) {
+            if (current == baselines.end()) {
+                baselines.emplace_back(commit, Programs{});
+                current = std::prev(baselines.end());
+            }
+            auto &programs = current->second;
+            auto entry = std::ranges::find(programs, name, &Programs::value_type::first);
+            if (entry == programs.end()) {
+                programs.emplace_back(name, stats);
+                writeBaselines(baselineFile, baselines);
+            } else if (update) {
+                entry->second = stats;
+                writeBaselines(baselineFile, baselines);
+            }
+        }
+        return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+    } catch (const std::exception &error) {
+        fmt::print(stderr, "Error: {}\n", error.what());
+        return EXIT_FAILURE;
+    }
+}
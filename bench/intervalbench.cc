@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <fmt/format.h>
+#include <iostream>
+#include <list>
+#include <map>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchutil.hpp"
+#include "intervalset.hpp"
+
+// Union of random intervals with the two Intervals of day 15 (before
+// IntervalSet) and with IntervalSet, inserting one by one and as a batch.
+// "dense" intervals soon merge into a few long ones, "sparse" ones mostly
+// stay apart, "rows" are many small sets like the rows of day 15.
+
+// 2021.cc, a std::list walked from the front
+struct ListIntervals {
+    std::list<std::pair<int64_t, int64_t>> intervals;
+
+    void insert(int64_t left, int64_t right) {
+        decltype(intervals) newIntervals{};
+        while (!intervals.empty()) {
+            if (right + 1 < intervals.front().first) {
+                break;
+            } else if (left - 1 > intervals.front().second) {
+                newIntervals.splice(newIntervals.end(), intervals, intervals.begin());
+            } else {
+                left = std::min(left, intervals.front().first);
+                right = std::max(right, intervals.front().second);
+                intervals.pop_front();
+            }
+        }
+        intervals.emplace_front(left, right);
+        intervals.splice(intervals.begin(), newIntervals);
+    }
+
+    int64_t length() const {
+        int64_t total = 0;
+        for (const auto &[left, right] : intervals) {
+            total += right - left + 1;
+        }
+        return total;
+    }
+};
+
+// 2021map.cc, a std::map from left to right end
+struct MapIntervals {
+    std::map<int64_t, int64_t> intervals;
+
+    void insert(int64_t left, int64_t right) {
+        auto next = intervals.lower_bound(left);
+        if (next != intervals.end() and next->first == left) {
+            next->second = std::max(next->second, right);
+        } else {
+            next = intervals.emplace_hint(next, left, right);
+        }
+        auto prev = next;
+        if (next != intervals.begin()) {
+            --prev;
+        } else {
+            ++next;
+        }
+        while (next != intervals.end()) {
+            if (next->first <= prev->second + 1) {
+                prev->second = std::max(prev->second, next->second);
+                next = intervals.erase(next);
+            } else if (prev->first < left) {
+                ++prev;
+                ++next;
+            } else {
+                break;
+            }
+        }
+    }
+
+    int64_t length() const {
+        int64_t total = 0;
+        for (const auto &[left, right] : intervals) {
+            total += right - left + 1;
+        }
+        return total;
+    }
+};
+
+std::vector<Interval> generate(const int64_t count, const int64_t range, const int64_t maxLength) {
+    std::mt19937_64 rng{2022};
+    std::uniform_int_distribution<int64_t> start{0, range};
+    std::uniform_int_distribution<int64_t> length{1, maxLength};
+    std::vector<Interval> intervals(static_cast<size_t>(count));
+    for (auto &interval : intervals) {
+        interval.from = start(rng);
+        interval.to = interval.from + length(rng) - 1;
+    }
+    return intervals;
+}
+
+template <typename Set> int64_t oneByOne(const std::vector<Interval> &intervals) {
+    Set set{};
+    for (const auto &[from, to] : intervals) {
+        set.insert(from, to);
+    }
+    return set.length();
+}
+
+// like day 15: a fresh set for every row of rowLength intervals
+template <typename Set>
+int64_t rowsOneByOne(const std::vector<Interval> &intervals, const size_t rowLength) {
+    int64_t total = 0;
+    for (size_t row = 0; row < intervals.size(); row += rowLength) {
+        Set set{};
+        for (size_t i = row; i < std::min(row + rowLength, intervals.size()); ++i) {
+            set.insert(intervals[i].from, intervals[i].to);
+        }
+        total += set.length();
+    }
+    return total;
+}
+
+int64_t rowsBatch(const std::vector<Interval> &intervals, const size_t rowLength) {
+    int64_t total = 0;
+    IntervalSet set{};
+    for (size_t row = 0; row < intervals.size(); row += rowLength) {
+        set.clear();
+        set.insert(std::span{intervals}.subspan(row, std::min(rowLength, intervals.size() - row)));
+        total += set.length();
+    }
+    return total;
+}
+
+std::string line(const std::string &name, const double seconds, const int64_t checksum) {
+    return fmt::format("  {:24s} {:10.2f} ms  (checksum {})", name, seconds * 1000., checksum);
+}
+
+void compare(const std::string &name, const std::vector<Interval> &intervals,
+             const bool quadratic) {
+    IntervalSet merged{intervals};
+    fmt::print("{}: {} intervals merge into {} (best of 3):\n", name, intervals.size(),
+               merged.size());
+    // the list and the vector shift every merged interval on each insert
+    if (quadratic) {
+        measure("std::list", 3, [&] { return oneByOne<ListIntervals>(intervals); }, line);
+    } else {
+        fmt::print("  {:24s} skipped, quadratic\n", "std::list");
+    }
+    measure("std::map", 3, [&] { return oneByOne<MapIntervals>(intervals); }, line);
+    if (quadratic) {
+        measure(
+            "IntervalSet one by one", 3, [&] { return oneByOne<IntervalSet>(intervals); }, line);
+    } else {
+        fmt::print("  {:24s} skipped, quadratic\n", "IntervalSet one by one");
+    }
+    measure("IntervalSet batch", 3, [&] { return IntervalSet{intervals}.length(); }, line);
+}
+
+int main(int argc, char **argv) {
+    const int64_t count = (argc > 1) ? std::stol(argv[1]) : 1'000'000;
+    if (count <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [intervals]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    compare("dense", generate(count, count * 100, 10'000), true);
+    compare("sparse", generate(count, count * 1'000, 100), count <= 10'000);
+
+    // day 15 sized rows, the sensors of the puzzle reach about 30 ranges
+    const size_t rowLength = 32;
+    const auto rows = generate(count, 4'000'000, 1'000'000);
+    fmt::print("rows: {} intervals in rows of {} (best of 3):\n", rows.size(), rowLength);
+    measure("std::list", 3, [&] { return rowsOneByOne<ListIntervals>(rows, rowLength); }, line);
+    measure("std::map", 3, [&] { return rowsOneByOne<MapIntervals>(rows, rowLength); }, line);
+    measure(
+        "IntervalSet one by one", 3,
+        [&] { return rowsOneByOne<IntervalSet>(rows, rowLength); }, line);
+    measure("IntervalSet batch", 3, [&] { return rowsBatch(rows, rowLength); }, line);
+}
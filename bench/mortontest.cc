@@ -0,0 +1,133 @@
+#include <cstdint>
+#include <fmt/format.h>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "morton.hpp"
+#include "vec2.hpp"
+#include "vec3.hpp"
+
+// Checks of the Morton codes at the limits of their lanes, run ./mortontest,
+// it exits with failure if any check fails.
+
+int failures = 0;
+
+void check(const std::string &name, const std::string_view got, const std::string_view expected) {
+    if (got == expected) {
+        fmt::print("  ok    {}\n", name);
+    } else {
+        fmt::print("  FAIL  {}: got \"{}\", expected \"{}\"\n", name, got, expected);
+        ++failures;
+    }
+}
+
+constexpr int32_t min2 = std::numeric_limits<int32_t>::min();
+constexpr int32_t max2 = std::numeric_limits<int32_t>::max();
+constexpr int32_t min3 = -(1 << 20);
+constexpr int32_t max3 = (1 << 20) - 1;
+
+// around the limits and around zero, where the bias carries through a lane
+const std::vector<int32_t> values2 = {min2, min2 + 1, -2, -1, 0, 1, max2 - 1, max2};
+const std::vector<int32_t> values3 = {min3, min3 + 1, -2, -1, 0, 1, max3 - 1, max3};
+
+// Collects the vectors a check failed for, empty if there are none.
+class Wrong {
+    int64_t count{0};
+    std::string first{};
+
+  public:
+    void add(const auto &v) {
+        if (count++ == 0) {
+            first = fmt::format("{}", v);
+        }
+    }
+    std::string str() const {
+        return count == 0 ? "" : fmt::format("{} vectors, the first {}", count, first);
+    }
+};
+
+// the vectors that don't survive encode and decode
+std::string wrongRoundTrips() {
+    Wrong wrong{};
+    for (const auto x : values2) {
+        for (const auto y : values2) {
+            if (Morton::decode2(Morton::encode(Vec2i{x, y})) != Vec2i{x, y}) {
+                wrong.add(Vec2i{x, y});
+            }
+        }
+    }
+    for (const auto x : values3) {
+        for (const auto y : values3) {
+            for (const auto z : values3) {
+                if (Morton::decode3(Morton::encode(Vec3i{x, y, z})) != Vec3i{x, y, z}) {
+                    wrong.add(Vec3i{x, y, z});
+                }
+            }
+        }
+    }
+    return wrong.str();
+}
+
+// position of v along the lane of unit
+int64_t along(const Vec2i &v, const Vec2i &unit) { return v.x * unit.x + v.y * unit.y; }
+int64_t along(const Vec3i &v, const Vec3i &unit) {
+    return v.x * unit.x + v.y * unit.y + v.z * unit.z;
+}
+
+// the vectors where stepping lane by unit is not the code of v + unit, the
+// other lanes hold limit values so a carry leaking into them shows up
+template <uint64_t lane, typename Vec>
+std::string wrongSteps(const Vec &unit, const std::vector<int32_t> &values) {
+    Wrong wrong{};
+    const auto visit = [&](const Vec &v) {
+        // the last value of the lane has no successor
+        if (along(v, unit) == values.back()) {
+            return;
+        }
+        const auto code = Morton::encode(v);
+        const auto next = Morton::encode(v + unit);
+        if (Morton::inc<lane>(code) != next or Morton::dec<lane>(next) != code) {
+            wrong.add(v);
+        }
+    };
+    for (const auto x : values) {
+        for (const auto y : values) {
+            if constexpr (std::is_same_v<Vec, Vec3i>) {
+                for (const auto z : values) {
+                    visit({x, y, z});
+                }
+            } else {
+                visit({x, y});
+            }
+        }
+    }
+    return wrong.str();
+}
+
+void roundTrips() { check("encode and decode at the limits", wrongRoundTrips(), ""); }
+
+void steps() {
+    check("inc and dec of x2", wrongSteps<Morton::x2>(Vec2i{1, 0}, values2), "");
+    check("inc and dec of y2", wrongSteps<Morton::y2>(Vec2i{0, 1}, values2), "");
+    check("inc and dec of x3", wrongSteps<Morton::x3>(Vec3i{1, 0, 0}, values3), "");
+    check("inc and dec of y3", wrongSteps<Morton::y3>(Vec3i{0, 1, 0}, values3), "");
+    check("inc and dec of z3", wrongSteps<Morton::z3>(Vec3i{0, 0, 1}, values3), "");
+
+    // past the end a lane wraps around without touching the others
+    const auto top = Morton::inc<Morton::y3>(Morton::encode(Vec3i{max3, max3, max3}));
+    check("inc wraps within the lane", fmt::format("{}", Morton::decode3(top)),
+          fmt::format("{}", Vec3i{max3, min3, max3}));
+    const auto bottom = Morton::dec<Morton::x2>(Morton::encode(Vec2i{min2, min2}));
+    check("dec wraps within the lane", fmt::format("{}", Morton::decode2(bottom)),
+          fmt::format("{}", Vec2i{max2, min2}));
+}
+
+int main() {
+    fmt::print("Morton:\n");
+    roundTrips();
+    steps();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,121 @@
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include "simpleparser.hpp"
+#include "timeit.hpp"
+
+// Compare the ifstream and the memory mapped backend of SimpleParser with
+// each scanning kernel the CPU supports. Every file is tokenized completely,
+// numbers are summed up as a checksum. With -s the input files are repeated
+// up to the given size first.
+
+struct Result {
+    int64_t tokens{};
+    int64_t checksum{};
+    double seconds{};
+};
+
+Result tokenize(SimpleParser &scanner) {
+    Result result{};
+    while (!scanner.isEof()) {
+        if (std::isdigit(scanner.peekChar())) {
+            result.checksum += scanner.getInt64();
+        } else {
+            result.checksum += static_cast<int64_t>(scanner.getTokenView().size());
+        }
+        ++result.tokens;
+    }
+    return result;
+}
+
+template <typename... Args> Result run(const int64_t repeat, Args... args) {
+    Result best{};
+    for (int64_t i = 0; i < repeat; ++i) {
+        const auto start = timeNow();
+        SimpleParser scanner{args...};
+        auto result = tokenize(scanner);
+        result.seconds = timeDiff(start, timeNow());
+        if (i == 0 or result.seconds < best.seconds) {
+            best = result;
+        }
+    }
+    return best;
+}
+
+void report(const std::string &name, const Result &result, const double megabytes) {
+    fmt::print("  {:16s} {:10.4f} ms {:8.3f} GB/s  ({} tokens, checksum {})\n", name,
+               result.seconds * 1000., megabytes / 1000. / result.seconds, result.tokens,
+               result.checksum);
+}
+
+// write copies of filename into a temporary file until it has the given size
+std::filesystem::path inflate(const char *filename, const double megabytes) {
+    std::ifstream infile{filename};
+    const std::string content{std::istreambuf_iterator<char>{infile}, {}};
+    const auto bigfile = std::filesystem::temp_directory_path() / "parsebench-input.txt";
+    std::ofstream out{bigfile};
+    double written = 0;
+    while (written < megabytes * 1e6 and !content.empty()) {
+        out << content;
+        if (content.back() != '\n') {
+            out << '\n';
+        }
+        written += static_cast<double>(content.size() + 1);
+    }
+    return bigfile;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " [-n repeat] [-s inflate to MB] <input.txt>...\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    int64_t repeat = 5;
+    double inflateTo = 0;
+    for (int arg = 1; arg < argc; ++arg) {
+        if (std::string{argv[arg]} == "-n" and arg + 1 < argc) {
+            repeat = std::stol(argv[++arg]);
+            continue;
+        }
+        if (std::string{argv[arg]} == "-s" and arg + 1 < argc) {
+            inflateTo = std::stod(argv[++arg]);
+            continue;
+        }
+        const auto path = inflateTo > 0 ? inflate(argv[arg], inflateTo)
+                                        : std::filesystem::path{argv[arg]};
+        const char *filename = path.c_str();
+        const double megabytes = static_cast<double>(std::filesystem::file_size(path)) / 1e6;
+
+        fmt::print("{} ({:.2f} MB, best of {}):\n", argv[arg], megabytes, repeat);
+        std::optional<Result> reference{};
+        for (const auto level :
+             {SimdScan::Level::scalar, SimdScan::Level::sse2, SimdScan::Level::avx2}) {
+            const std::string kernel = SimdScan::select(level);
+            if (SimdScan::active.level != level) {
+                continue;
+            }
+            const auto stream = run(repeat, filename);
+            report("ifstream " + kernel, stream, megabytes);
+            const auto mapped = run(repeat, filename, SimpleParser::memoryMapped);
+            report("mmap " + kernel, mapped, megabytes);
+            if (!reference) {
+                reference = stream;
+            }
+            for (const auto &result : {stream, mapped}) {
+                if (result.checksum != reference->checksum or
+                    result.tokens != reference->tokens) {
+                    fmt::print("  Error: backends disagree\n");
+                }
+            }
+        }
+        SimdScan::select(SimdScan::bestLevel());
+        if (inflateTo > 0) {
+            std::filesystem::remove(path);
+        }
+    }
+}
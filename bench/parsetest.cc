@@ -0,0 +1,61 @@
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+#include "simpleparser.hpp"
+
+// Regression checks for SimpleParser corner cases, run ./parsetest, it
+// exits with failure if any check fails.
+
+int failures = 0;
+
+void check(const std::string &name, const std::string_view got, const std::string_view expected) {
+    if (got == expected) {
+        fmt::print("  ok    {}\n", name);
+    } else {
+        fmt::print("  FAIL  {}: got \"{}\", expected \"{}\"\n", name, got, expected);
+        ++failures;
+    }
+}
+
+// input written to a temporary file, so the parser reads it as a stream
+std::filesystem::path writeInput(const std::string &content) {
+    const auto path = std::filesystem::temp_directory_path() / "parsetest-input.txt";
+    std::ofstream{path} << content;
+    return path;
+}
+
+// a view of the last token of a line must survive a blank line and the
+// line after it being read
+void blankLineKeepsView() {
+    const auto path = writeInput("alphaalphaalphaalphaalpha\n\nbetabetabetabetabetabetabeta\n");
+    SimpleParser scanner{path.c_str()};
+    const auto first = scanner.getTokenView();
+    const auto second = scanner.getTokenView();
+    check("view across a blank line", first, "alphaalphaalphaalphaalpha");
+    check("token after a blank line", second, "betabetabetabetabetabetabeta");
+    std::filesystem::remove(path);
+}
+
+// a token only stops at the next literal if that follows the field
+// directly, here the 'h' of "has" is part of the valve name
+void scanTerminators() {
+    SimpleParser spaced{std::string_view{"Valve zh has flow rate=5\n"}};
+    const auto valve = spaced.scan<"Valve {s} has flow rate={}">();
+    check("token before a spaced literal", valve ? std::get<0>(*valve) : "(no match)", "zh");
+    check("number after it", valve ? fmt::format("{}", std::get<1>(*valve)) : "", "5");
+
+    SimpleParser adjacent{std::string_view{"key:42\n"}};
+    const auto pair = adjacent.scan<"{s}:{}">();
+    check("token before an adjacent literal", pair ? std::get<0>(*pair) : "(no match)", "key");
+}
+
+int main() {
+    fmt::print("SimpleParser:\n");
+    blankLineKeepsView();
+    scanTerminators();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,83 @@
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "benchutil.hpp"
+#include "simpleparser.hpp"
+
+// Parse generated day 19 blueprints with a chain of skipToken()/getInt64()
+// calls and with SimpleParser::scan<>().
+
+void generate(const std::filesystem::path &filename, const int64_t count) {
+    std::ofstream out{filename};
+    std::mt19937_64 rng{2022};
+    std::uniform_int_distribution<int64_t> cost{2, 20};
+    for (int64_t id = 1; id <= count; ++id) {
+        out << fmt::format("Blueprint {}: Each ore robot costs {} ore. Each clay robot costs {} "
+                           "ore. Each obsidian robot costs {} ore and {} clay. Each geode robot "
+                           "costs {} ore and {} obsidian.\n",
+                           id, cost(rng), cost(rng), cost(rng), cost(rng), cost(rng), cost(rng));
+    }
+}
+
+int64_t parseChain(const char *filename) {
+    SimpleParser scanner{filename, SimpleParser::memoryMapped};
+    int64_t checksum = 0;
+    while (!scanner.isEof()) {
+        scanner.skipToken("Blueprint");
+        checksum += scanner.getInt64();
+        scanner.skipToken(": Each ore robot costs");
+        checksum += scanner.getInt64();
+        scanner.skipToken("ore. Each clay robot costs");
+        checksum += scanner.getInt64();
+        scanner.skipToken("ore. Each obsidian robot costs");
+        checksum += scanner.getInt64();
+        scanner.skipToken("ore and");
+        checksum += scanner.getInt64();
+        scanner.skipToken("clay. Each geode robot costs");
+        checksum += scanner.getInt64();
+        scanner.skipToken("ore and");
+        checksum += scanner.getInt64();
+        scanner.skipToken("obsidian.");
+    }
+    return checksum;
+}
+
+int64_t parseScan(const char *filename) {
+    SimpleParser scanner{filename, SimpleParser::memoryMapped};
+    int64_t checksum = 0;
+    while (!scanner.isEof()) {
+        const auto blueprint = scanner.scan<
+            "Blueprint {}: Each ore robot costs {} ore. Each clay robot costs {} ore. "
+            "Each obsidian robot costs {} ore and {} clay. "
+            "Each geode robot costs {} ore and {} obsidian.">();
+        if (blueprint) {
+            std::apply([&](const auto... value) { checksum += (value + ...); }, *blueprint);
+        }
+    }
+    return checksum;
+}
+
+int main(int argc, char **argv) {
+    const int64_t count = (argc > 1) ? std::stol(argv[1]) : 1000000;
+    if (count <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [blueprint count]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const auto filename = std::filesystem::temp_directory_path() / "scanbench-blueprints.txt";
+    generate(filename, count);
+    fmt::print("{} blueprints, {:.2f} MB (best of 5):\n", count,
+               static_cast<double>(std::filesystem::file_size(filename)) / 1e6);
+    const auto perBlueprint = [&](const std::string &name, const double seconds,
+                                  const int64_t checksum) {
+        return fmt::format("  {:10s} {:10.4f} ms {:8.1f} ns/blueprint  (checksum {})", name,
+                           seconds * 1000., seconds * 1e9 / static_cast<double>(count), checksum);
+    };
+    measure("skipToken", 5, [&] { return parseChain(filename.c_str()); }, perBlueprint);
+    measure("scan<>", 5, [&] { return parseScan(filename.c_str()); }, perBlueprint);
+    std::filesystem::remove(filename);
+}
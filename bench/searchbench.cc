@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <fmt/format.h>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchutil.hpp"
+#include "graphsearch.hpp"
+#include "grid2d.hpp"
+#include "utility.hpp"
+#include "vec2.hpp"
+
+// Shortest path between opposite corners of a generated map with random
+// walls: breadth first search, bidirectional search and A* with the bucket
+// queue of graphsearch.hpp, and A* with a std::priority_queue like day 24
+// used to have. Visited marks are only cleared, never reallocated. Then
+// once more with the goal walled in. Fails if the searches disagree.
+
+const std::vector<Vec2l> directions = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+// '#' walls with a border of walls around the map, far enough below the 40%
+// at which walls start to cut the map into pieces
+Grid2D<char> generateMap(const int64_t size) {
+    Grid2D<char> map{{static_cast<size_t>(size), static_cast<size_t>(size)}, '.', 1, '#'};
+    std::mt19937_64 rng{2022};
+    std::uniform_int_distribution<int> percent{0, 99};
+    for (int64_t y = 0; y < size; ++y) {
+        for (int64_t x = 0; x < size; ++x) {
+            if (percent(rng) < 25) {
+                map[Vec2l{x, y}] = '#';
+            }
+        }
+    }
+    // free corners, so start and goal aren't walled in on their own
+    for (int64_t y = 0; y < std::min<int64_t>(size, 4); ++y) {
+        for (int64_t x = 0; x < std::min<int64_t>(size, 4); ++x) {
+            map[Vec2l{x, y}] = '.';
+            map[Vec2l{size - 1 - x, size - 1 - y}] = '.';
+        }
+    }
+    return map;
+}
+
+struct Maze {
+    const Grid2D<char> &map;
+    Vec2l start;
+    Vec2l goal;
+    GraphSearch::Visited seen;
+    GraphSearch::Visited seenBack;
+
+    explicit Maze(const Grid2D<char> &map)
+        : map(map), start{0, 0}, goal{map.width() - 1, map.height() - 1},
+          seen(static_cast<size_t>(map.width() * map.height())),
+          seenBack(static_cast<size_t>(map.width() * map.height())) {}
+
+    size_t index(const Vec2l &pos) const {
+        return static_cast<size_t>(pos.y * map.width() + pos.x);
+    }
+
+    // free neighbours, the border keeps them inside the map
+    void neighbours(const Vec2l &pos, auto emit) const {
+        for (const auto &direction : directions) {
+            const auto next = pos + direction;
+            if (map[next] != '#') {
+                emit(next);
+            }
+        }
+    }
+
+    int64_t bfs() {
+        seen.clear();
+        seen.insert(index(start));
+        return GraphSearch::bfs(
+            std::vector{start},
+            [&](const Vec2l &pos, auto emit) {
+                neighbours(pos, [&](const Vec2l &next) {
+                    if (seen.insert(index(next))) {
+                        emit(next);
+                    }
+                });
+            },
+            [&](const Vec2l &pos, int64_t) { return pos == goal; });
+    }
+
+    int64_t bidirectional() {
+        const auto both = [&](const Vec2l &pos, auto emit) { neighbours(pos, emit); };
+        return GraphSearch::bidirectional(
+            start, goal, [&](const Vec2l &pos) { return index(pos); }, both, both, seen,
+            seenBack);
+    }
+
+    // both A* close a position when it is taken from the queue, a shorter
+    // way to it may still turn up while it waits there
+    int64_t astar() {
+        seen.clear();
+        return GraphSearch::astar(
+            start,
+            [&](const Vec2l &pos, auto emit) {
+                if (!seen.insert(index(pos))) {
+                    return;
+                }
+                neighbours(pos, [&](const Vec2l &next) {
+                    if (!seen.contains(index(next))) {
+                        emit(next, 1);
+                    }
+                });
+            },
+            [&](const Vec2l &pos) { return manhattan(pos, goal); },
+            [&](const Vec2l &pos) { return pos == goal; });
+    }
+
+    int64_t priorityQueue() {
+        struct State {
+            Vec2l pos;
+            int64_t cost;
+        };
+        const auto later = [&](const State &a, const State &b) {
+            return a.cost + manhattan(a.pos, goal) > b.cost + manhattan(b.pos, goal);
+        };
+        std::priority_queue<State, std::vector<State>, decltype(later)> frontier{later};
+        seen.clear();
+        frontier.push({start, 0});
+        while (!frontier.empty()) {
+            const auto current = frontier.top();
+            frontier.pop();
+            if (current.pos == goal) {
+                return current.cost;
+            }
+            if (!seen.insert(index(current.pos))) {
+                continue;
+            }
+            neighbours(current.pos, [&](const Vec2l &next) {
+                if (!seen.contains(index(next))) {
+                    frontier.push({next, current.cost + 1});
+                }
+            });
+        }
+        return -1;
+    }
+};
+
+std::string line(const std::string &name, const double seconds, const int64_t distance) {
+    return fmt::format("  {:20s} {:10.2f} ms  (distance {})", name, seconds * 1000., distance);
+}
+
+// the distance every search found
+std::vector<int64_t> searchAll(Maze &maze, const int64_t runs) {
+    return {measure("bfs", runs, [&] { return maze.bfs(); }, line),
+            measure("bidirectional", runs, [&] { return maze.bidirectional(); }, line),
+            measure("A* buckets", runs, [&] { return maze.astar(); }, line),
+            measure("A* priority_queue", runs, [&] { return maze.priorityQueue(); }, line)};
+}
+
+int main(int argc, char **argv) {
+    const int64_t size = (argc > 1) ? std::stol(argv[1]) : 2000;
+    if (size <= 1) {
+        std::cerr << "Usage: " << argv[0] << " [map size]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const auto map = generateMap(size);
+    Maze maze{map};
+    fmt::print("{0}x{0} map with 25% walls, corner to corner (best of 3):\n", size);
+    const auto distances = searchAll(maze, 3);
+
+    auto walled = map;
+    walled[maze.goal - Vec2l{1, 0}] = '#';
+    walled[maze.goal - Vec2l{0, 1}] = '#';
+    Maze closed{walled};
+    fmt::print("the same map with the goal walled in (one run):\n");
+    const auto unreachable = searchAll(closed, 1);
+
+    if (std::ranges::count(distances, distances.front()) != std::ssize(distances) or
+        std::ranges::count(unreachable, -1) != std::ssize(unreachable)) {
+        fmt::print(stderr, "Error: the searches disagree\n");
+        return EXIT_FAILURE;
+    }
+}
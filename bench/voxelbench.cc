@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fmt/format.h>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchutil.hpp"
+#include "morton.hpp"
+#include "timeit.hpp"
+#include "vec3.hpp"
+#include "voxelgrid.hpp"
+
+// Day 18 on a generated droplet filling a size^3 box: a ball with closed
+// air bubbles inside and open pits in its surface. Compares testing every
+// voxel, bits in Morton order with lane stepped neighbours and the word
+// operations of VoxelGrid.
+
+const std::vector<Vec3l> directions = {{-1, 0, 0}, {1, 0, 0}, {0, -1, 0},
+                                       {0, 1, 0},  {0, 0, -1}, {0, 0, 1}};
+
+struct Ball {
+    Vec3l center;
+    int64_t radius;
+};
+
+// set (or reset) the voxels of ball, row by row
+void drawBall(VoxelGrid &grid, const Ball &ball, const bool value) {
+    for (auto z = ball.center.z - ball.radius; z <= ball.center.z + ball.radius; ++z) {
+        for (auto y = ball.center.y - ball.radius; y <= ball.center.y + ball.radius; ++y) {
+            const auto dy = y - ball.center.y;
+            const auto dz = z - ball.center.z;
+            const auto left = ball.radius * ball.radius - dy * dy - dz * dz;
+            if (left < 0 or !grid.contains({ball.center.x, y, z})) {
+                continue;
+            }
+            const auto dx = static_cast<int64_t>(std::sqrt(static_cast<double>(left)));
+            grid.setSpan(y, z, std::max(ball.center.x - dx, grid.min().x + 1),
+                         std::min(ball.center.x + dx, grid.max().x - 1), value);
+        }
+    }
+}
+
+VoxelGrid generateDroplet(const int64_t size) {
+    // one voxel of air around the droplet, like surface.cc
+    VoxelGrid lava{{-1, -1, -1}, {size, size, size}};
+    const Vec3l center{size / 2, size / 2, size / 2};
+    const auto radius = size * 9 / 20;
+    drawBall(lava, {center, radius}, true);
+
+    std::mt19937_64 rng{2022};
+    std::uniform_real_distribution<double> unit{-1.0, 1.0};
+    const auto randomPoint = [&](const double distance) {
+        Vec3l offset{};
+        double length = 0;
+        do {
+            offset = {static_cast<int64_t>(unit(rng) * 1000.),
+                      static_cast<int64_t>(unit(rng) * 1000.),
+                      static_cast<int64_t>(unit(rng) * 1000.)};
+            length = std::sqrt(static_cast<double>(offset.x * offset.x + offset.y * offset.y +
+                                                   offset.z * offset.z));
+        } while (length < 1. or length > 1000.);
+        const auto scale = distance / length;
+        return center + Vec3l{static_cast<int64_t>(static_cast<double>(offset.x) * scale),
+                              static_cast<int64_t>(static_cast<double>(offset.y) * scale),
+                              static_cast<int64_t>(static_cast<double>(offset.z) * scale)};
+    };
+    const auto small = std::max<int64_t>(size / 40, 1);
+    for (int64_t i = 0; i < 200; ++i) {
+        // closed bubble well inside
+        drawBall(lava, {randomPoint(static_cast<double>(radius) * 0.6), small}, false);
+        // pit open to the outside
+        drawBall(lava, {randomPoint(static_cast<double>(radius)), small * 2}, false);
+    }
+    return lava;
+}
+
+int64_t facesPerVoxel(const VoxelGrid &lava) {
+    int64_t faces = 0;
+    for (auto z = lava.min().z + 1; z < lava.max().z; ++z) {
+        for (auto y = lava.min().y + 1; y < lava.max().y; ++y) {
+            for (auto x = lava.min().x + 1; x < lava.max().x; ++x) {
+                if (!lava.test({x, y, z})) {
+                    continue;
+                }
+                for (const auto &direction : directions) {
+                    if (!lava.test(Vec3l{x, y, z} + direction)) {
+                        ++faces;
+                    }
+                }
+            }
+        }
+    }
+    return faces;
+}
+
+int64_t floodPerVoxel(const VoxelGrid &lava) {
+    VoxelGrid water{lava.min(), lava.max()};
+    std::vector<Vec3l> toFill{lava.min()};
+    water.set(lava.min());
+    while (!toFill.empty()) {
+        const auto current = toFill.back();
+        toFill.pop_back();
+        for (const auto &direction : directions) {
+            const auto next = current + direction;
+            if (lava.contains(next) and !water.test(next) and !lava.test(next)) {
+                water.set(next);
+                toFill.push_back(next);
+            }
+        }
+    }
+    return static_cast<int64_t>(lava.facesTouching(water));
+}
+
+// The droplet as bits indexed by the Morton code of the voxel relative to
+// the box, neighbours are lane increments and decrements of the code.
+class MortonVoxels {
+    std::vector<uint64_t> words;
+    // the largest code inside the box for every lane
+    uint64_t limitX;
+    uint64_t limitY;
+    uint64_t limitZ;
+
+  public:
+    explicit MortonVoxels(const VoxelGrid &grid) {
+        const auto size = grid.max() - grid.min();
+        limitX = Morton::interleave3(static_cast<uint64_t>(size.x), 0, 0);
+        limitY = Morton::interleave3(0, static_cast<uint64_t>(size.y), 0);
+        limitZ = Morton::interleave3(0, 0, static_cast<uint64_t>(size.z));
+        words.resize(((limitX | limitY | limitZ) + 64) / 64);
+        for (int64_t z = 0; z <= size.z; ++z) {
+            for (int64_t y = 0; y <= size.y; ++y) {
+                for (int64_t x = 0; x <= size.x; ++x) {
+                    if (grid.test(grid.min() + Vec3l{x, y, z})) {
+                        set(Morton::interleave3(static_cast<uint64_t>(x),
+                                                static_cast<uint64_t>(y),
+                                                static_cast<uint64_t>(z)));
+                    }
+                }
+            }
+        }
+    }
+
+    // an empty box of the same size
+    MortonVoxels emptyCopy() const {
+        auto copy = *this;
+        std::ranges::fill(copy.words, 0);
+        return copy;
+    }
+
+    bool test(const uint64_t code) const { return (words[code / 64] >> (code % 64)) & 1; }
+    void set(const uint64_t code) { words[code / 64] |= uint64_t{1} << (code % 64); }
+
+    void forEach(auto fn) const {
+        for (size_t i = 0; i < words.size(); ++i) {
+            for (auto word = words[i]; word != 0; word &= word - 1) {
+                fn(i * 64 + static_cast<uint64_t>(std::countr_zero(word)));
+            }
+        }
+    }
+
+    // call fn(code) for the neighbours inside the box
+    void neighbours(const uint64_t code, auto fn) const {
+        if ((code & Morton::x3) != 0) {
+            fn(Morton::dec<Morton::x3>(code));
+        }
+        if ((code & Morton::x3) != limitX) {
+            fn(Morton::inc<Morton::x3>(code));
+        }
+        if ((code & Morton::y3) != 0) {
+            fn(Morton::dec<Morton::y3>(code));
+        }
+        if ((code & Morton::y3) != limitY) {
+            fn(Morton::inc<Morton::y3>(code));
+        }
+        if ((code & Morton::z3) != 0) {
+            fn(Morton::dec<Morton::z3>(code));
+        }
+        if ((code & Morton::z3) != limitZ) {
+            fn(Morton::inc<Morton::z3>(code));
+        }
+    }
+};
+
+// faces of a voxel of lava next to a voxel of other
+int64_t facesMorton(const MortonVoxels &lava, const MortonVoxels &other, const bool touching) {
+    int64_t faces = 0;
+    lava.forEach([&](const uint64_t drop) {
+        lava.neighbours(drop, [&](const uint64_t next) {
+            if (other.test(next) == touching) {
+                ++faces;
+            }
+        });
+    });
+    return faces;
+}
+
+int64_t floodMorton(const MortonVoxels &lava) {
+    // the corner of the box is outside of the lava
+    auto water = lava.emptyCopy();
+    std::vector<uint64_t> toFill{0};
+    water.set(0);
+    while (!toFill.empty()) {
+        const auto current = toFill.back();
+        toFill.pop_back();
+        lava.neighbours(current, [&](const uint64_t next) {
+            if (!water.test(next) and !lava.test(next)) {
+                water.set(next);
+                toFill.push_back(next);
+            }
+        });
+    }
+    return facesMorton(lava, water, true);
+}
+
+int main(int argc, char **argv) {
+    const int64_t size = (argc > 1) ? std::stol(argv[1]) : 1000;
+    if (size <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [droplet size]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const auto start = timeNow();
+    const auto lava = generateDroplet(size);
+    fmt::print("{0}x{0}x{0} droplet, {1} voxels of lava, generated in {2:.2f} ms (best of 3):\n",
+               size, lava.count(), timeDiff(start, timeNow()) * 1000.);
+
+    measure("faces per voxel", 3, [&] { return facesPerVoxel(lava); });
+    const MortonVoxels morton{lava};
+    measure("faces Morton", 3, [&] { return facesMorton(morton, morton, false); });
+    measure("faces VoxelGrid", 3, [&] {
+        return static_cast<int64_t>(6 * lava.count() - lava.facesTouching(lava));
+    });
+    // the stack of the per voxel flood gets too large for big droplets
+    if (size <= 500) {
+        measure("flood per voxel", 3, [&] { return floodPerVoxel(lava); });
+        measure("flood Morton", 3, [&] { return floodMorton(morton); });
+    } else {
+        fmt::print("  {:20s} skipped above size 500\n", "flood per voxel");
+        fmt::print("  {:20s} skipped above size 500\n", "flood Morton");
+    }
+    measure("flood VoxelGrid", 3, [&] {
+        return static_cast<int64_t>(lava.facesTouching(lava.reachable(lava.min())));
+    });
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "profiler.hpp"
+
+// Replaces the global operator new and delete to count the allocations of
+// every ScopedTimer and PerfRegion, see profiler.hpp.
+// usage:
+// #include "allocationcounter.hpp"    - in one source file of the program
+//
+// Bytes are those malloc hands out (malloc_usable_size), so they include
+// its rounding. Aligned new and delete keep the library versions and are
+// not counted. Without -DPROFILE or glibc nothing is replaced.
+
+#if defined(PROFILE) && defined(__GLIBC__)
+
+#include <algorithm>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+namespace Profile {
+inline void countAllocation(void *pointer) {
+    auto &counters = allocations;
+    if (counters.ignore > 0) {
+        return;
+    }
+    const auto size = static_cast<int64_t>(malloc_usable_size(pointer));
+    ++counters.count;
+    counters.bytes += size;
+    counters.live += size;
+    counters.peak = std::max(counters.peak, counters.live);
+}
+
+inline void countRelease(void *pointer) {
+    auto &counters = allocations;
+    if (counters.ignore > 0) {
+        return;
+    }
+    // may go below zero for memory of other threads or of the profiler
+    counters.live -= static_cast<int64_t>(malloc_usable_size(pointer));
+}
+} // namespace Profile
+
+// new[] and the nothrow versions of the library call this one
+void *operator new(const std::size_t size) {
+    auto *pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc{};
+    }
+    Profile::countAllocation(pointer);
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept {
+    if (pointer != nullptr) {
+        Profile::countRelease(pointer);
+        std::free(pointer);
+    }
+}
+
+void operator delete(void *pointer, std::size_t) noexcept { operator delete(pointer); }
+
+#endif
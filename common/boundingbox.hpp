@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "vec2.hpp"
+#include "vec3.hpp"
+
+// Bounding box of Vec2 / Vec3 positions, kept up to date while adding them.
+// usage:
+// BoundingBoxTracker<Vec2l> bounds{};
+// bounds.add(pos);                  - O(1), no branches
+// const auto [min, max] = bounds.box();
+//
+// The box only grows, removing positions is not tracked.
+
+namespace Bounds {
+template <typename num> constexpr Vec2<num> lower(const Vec2<num> &a, const Vec2<num> &b) {
+    return {std::min(a.x, b.x), std::min(a.y, b.y)};
+}
+template <typename num> constexpr Vec2<num> upper(const Vec2<num> &a, const Vec2<num> &b) {
+    return {std::max(a.x, b.x), std::max(a.y, b.y)};
+}
+template <typename num> constexpr Vec3<num> lower(const Vec3<num> &a, const Vec3<num> &b) {
+    return {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)};
+}
+template <typename num> constexpr Vec3<num> upper(const Vec3<num> &a, const Vec3<num> &b) {
+    return {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)};
+}
+
+// every coordinate set to value
+template <typename Vec> constexpr Vec splat(const decltype(Vec::x) value) {
+    if constexpr (is_instantiation_of<Vec3, Vec>::value) {
+        return {value, value, value};
+    } else {
+        return {value, value};
+    }
+}
+} // namespace Bounds
+
+template <typename Vec> class BoundingBoxTracker {
+    using num = decltype(Vec::x);
+
+    // empty, the first position added replaces both
+    Vec low{Bounds::splat<Vec>(std::numeric_limits<num>::max())};
+    Vec high{Bounds::splat<Vec>(std::numeric_limits<num>::lowest())};
+
+  public:
+    constexpr BoundingBoxTracker() = default;
+    constexpr explicit BoundingBoxTracker(const Vec &first) : low(first), high(first) {}
+
+    constexpr void add(const Vec &pos) {
+        low = Bounds::lower(low, pos);
+        high = Bounds::upper(high, pos);
+    }
+    constexpr void add(const BoundingBoxTracker &other) {
+        low = Bounds::lower(low, other.low);
+        high = Bounds::upper(high, other.high);
+    }
+
+    constexpr bool empty() const { return high.x < low.x; }
+    constexpr void clear() { *this = BoundingBoxTracker{}; }
+
+    // min() and max() are only valid if the box is not empty
+    constexpr const Vec &min() const { return low; }
+    constexpr const Vec &max() const { return high; }
+    constexpr std::pair<Vec, Vec> box() const { return {low, high}; }
+};
+
+template <typename Vec>
+constexpr std::pair<Vec, Vec> boundingBox(const BoundingBoxTracker<Vec> &bounds) {
+    return bounds.box();
+}
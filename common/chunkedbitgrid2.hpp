@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "flathash.hpp"
+#include "vec2.hpp"
+
+// Set of cells on an unbounded plane, one bit per cell.
+// usage:
+// ChunkedBitGrid2 visited{};
+// visited.insert(pos) - true if pos was not set before
+// visited.row(y, x)   - cells (x, y) .. (x + 63, y) as bits 0 .. 63
+//
+// The plane is split into 64x64 tiles, each tile stores one uint64_t per
+// row. Only tiles with cells ever set are allocated, they are found through
+// a FlatVecMap of tile coordinates. row() reads 64 neighbouring cells at
+// once, so neighbourhood checks become bit operations on words.
+class ChunkedBitGrid2 {
+    static constexpr int64_t tileBits = 6;
+    static constexpr int64_t tileSize = int64_t{1} << tileBits;
+    using Tile = std::array<uint64_t, tileSize>;
+
+    std::vector<Tile> tiles{};
+    // index into tiles for tile coordinates
+    FlatVecMap<Vec2l, uint32_t> tileIndex{};
+    size_t cells{0};
+    // last tiles found for even and odd tile x, simulations mostly stay in
+    // one place for a while and row() reads two neighbouring tiles
+    static constexpr Vec2l noTile{INT64_MAX, INT64_MAX};
+    mutable std::array<Vec2l, 2> lastTile{noTile, noTile};
+    mutable std::array<uint32_t, 2> lastIndex{};
+
+    static Vec2l tileOf(const Vec2l &pos) { return {pos.x >> tileBits, pos.y >> tileBits}; }
+    static uint64_t bitOf(const int64_t x) { return uint64_t{1} << (x & (tileSize - 1)); }
+    static size_t rowOf(const int64_t y) { return static_cast<size_t>(y & (tileSize - 1)); }
+
+    const uint32_t *findIndex(const Vec2l &tile) const {
+        const auto slot = static_cast<size_t>(tile.x & 1);
+        if (tile == lastTile[slot]) {
+            return &lastIndex[slot];
+        }
+        const auto *index = tileIndex.find(tile);
+        if (index != nullptr) {
+            lastTile[slot] = tile;
+            lastIndex[slot] = *index;
+        }
+        return index;
+    }
+
+    const Tile *findTile(const Vec2l &tile) const {
+        const auto *index = findIndex(tile);
+        return index != nullptr ? &tiles[*index] : nullptr;
+    }
+
+    Tile &getTile(const Vec2l &tile) {
+        if (const auto *index = findIndex(tile)) {
+            return tiles[*index];
+        }
+        tileIndex[tile] = static_cast<uint32_t>(tiles.size());
+        return tiles.emplace_back();
+    }
+
+    uint64_t tileRow(const int64_t tileX, const int64_t y) const {
+        const auto *tile = findTile({tileX, y >> tileBits});
+        return tile != nullptr ? (*tile)[rowOf(y)] : 0;
+    }
+
+  public:
+    bool contains(const Vec2l &pos) const {
+        const auto *tile = findTile(tileOf(pos));
+        return tile != nullptr and ((*tile)[rowOf(pos.y)] & bitOf(pos.x)) != 0;
+    }
+
+    // true if pos was not set before
+    bool insert(const Vec2l &pos) {
+        auto &row = getTile(tileOf(pos))[rowOf(pos.y)];
+        const auto bit = bitOf(pos.x);
+        if ((row & bit) != 0) {
+            return false;
+        }
+        row |= bit;
+        ++cells;
+        return true;
+    }
+
+    // true if pos was set, the tile stays allocated
+    bool erase(const Vec2l &pos) {
+        const auto *index = findIndex(tileOf(pos));
+        if (index == nullptr) {
+            return false;
+        }
+        auto &row = tiles[*index][rowOf(pos.y)];
+        const auto bit = bitOf(pos.x);
+        if ((row & bit) == 0) {
+            return false;
+        }
+        row &= ~bit;
+        --cells;
+        return true;
+    }
+
+    // number of set cells
+    size_t size() const { return cells; }
+    bool empty() const { return cells == 0; }
+
+    // drop all cells, keeps the memory for reuse
+    void clear() {
+        tiles.clear();
+        tileIndex.clear();
+        cells = 0;
+        lastTile = {noTile, noTile};
+    }
+
+    // cells (x, y) .. (x + 63, y) as bits 0 .. 63
+    uint64_t row(const int64_t y, const int64_t x) const {
+        const auto tileX = x >> tileBits;
+        const auto shift = x & (tileSize - 1);
+        const auto low = tileRow(tileX, y) >> shift;
+        if (shift == 0) {
+            return low;
+        }
+        return low | tileRow(tileX + 1, y) << (tileSize - shift);
+    }
+
+    // call fn(Vec2l) for every set cell, in no particular order
+    void forEach(auto fn) const {
+        for (const auto &[tile, index] : tileIndex) {
+            const auto &rows = tiles[index];
+            for (int64_t y = 0; y < tileSize; ++y) {
+                for (auto bits = rows[static_cast<size_t>(y)]; bits != 0; bits &= bits - 1) {
+                    fn(Vec2l{tile.x * tileSize + std::countr_zero(bits), tile.y * tileSize + y});
+                }
+            }
+        }
+    }
+
+    // std::pair<min, max> of the set cells, the grid must not be empty
+    std::pair<Vec2l, Vec2l> boundingBox() const {
+        Vec2l min{INT64_MAX, INT64_MAX};
+        Vec2l max{INT64_MIN, INT64_MIN};
+        for (const auto &[tile, index] : tileIndex) {
+            const auto &rows = tiles[index];
+            uint64_t columns = 0;
+            for (int64_t y = 0; y < tileSize; ++y) {
+                const auto bits = rows[static_cast<size_t>(y)];
+                if (bits != 0) {
+                    min.y = std::min(min.y, tile.y * tileSize + y);
+                    max.y = std::max(max.y, tile.y * tileSize + y);
+                    columns |= bits;
+                }
+            }
+            if (columns != 0) {
+                const auto left = tile.x * tileSize;
+                min.x = std::min(min.x, left + std::countr_zero(columns));
+                max.x = std::max(max.x, left + tileSize - 1 - std::countl_zero(columns));
+            }
+        }
+        return {min, max};
+    }
+};
+
+inline std::pair<Vec2l, Vec2l> boundingBox(const ChunkedBitGrid2 &grid) {
+    return grid.boundingBox();
+}
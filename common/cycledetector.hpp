@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+
+#include "flathash.hpp"
+
+// Finding where a simulation starts to repeat itself, and skipping ahead
+// over the repeats.
+// usage:
+// CycleDetector<Key, 3> loops{};       - Key like std::array<int64_t, 10>
+// if (const auto cycle = loops.check(key, {rocks, height, clock})) {
+//     CycleDetect::fastForward(counters, *cycle, limit);
+// }
+// const auto [start, length] = CycleDetect::brent(first, next);
+//
+// CycleDetector remembers the counters of every key it saw, keys are
+// hashed and compared as raw bytes, so they need a fixed size and no
+// padding. brent() and floyd() only keep two states, but they need a
+// function next(state) that alone decides the following state.
+
+namespace CycleDetect {
+// values that grow while the simulation runs, like rocks, height or clock
+template <size_t N> using Counters = std::array<int64_t, N>;
+
+template <typename Key> uint64_t hash(const Key &key) {
+    static_assert(std::is_trivially_copyable_v<Key> and
+                  std::has_unique_object_representations_v<Key>);
+    std::array<unsigned char, sizeof(Key)> bytes{};
+    std::memcpy(bytes.data(), &key, sizeof(Key));
+    uint64_t h = 0;
+    for (size_t i = 0; i < sizeof(Key); i += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes.data() + i, std::min(sizeof(uint64_t), sizeof(Key) - i));
+        h = FlatHash::mix(h * FlatHash::golden + word);
+    }
+    return h;
+}
+
+// Add cycle to counters as many times as possible without counters[0]
+// going beyond limit, returns the number of cycles skipped.
+template <size_t N>
+int64_t fastForward(Counters<N> &counters, const Counters<N> &cycle, const int64_t limit) {
+    const auto cycles = (limit - counters[0]) / cycle[0];
+    for (size_t i = 0; i < N; ++i) {
+        counters[i] += cycles * cycle[i];
+    }
+    return cycles;
+}
+
+// steps before the first state of the cycle, and steps of one cycle
+struct Cycle {
+    int64_t start;
+    int64_t length;
+};
+
+// tortoise and hare, three calls to next() per step while searching
+template <typename State, typename Next> Cycle floyd(const State &first, Next next) {
+    auto slow = next(first);
+    auto fast = next(next(first));
+    while (!(slow == fast)) {
+        slow = next(slow);
+        fast = next(next(fast));
+    }
+    // slow is a multiple of the length ahead, walk both to the cycle start
+    Cycle cycle{0, 1};
+    slow = first;
+    while (!(slow == fast)) {
+        slow = next(slow);
+        fast = next(fast);
+        ++cycle.start;
+    }
+    fast = next(slow);
+    while (!(slow == fast)) {
+        fast = next(fast);
+        ++cycle.length;
+    }
+    return cycle;
+}
+
+// teleporting tortoise, fewer calls to next() than floyd()
+template <typename State, typename Next> Cycle brent(const State &first, Next next) {
+    // find the length first: the tortoise waits at powers of two
+    int64_t power = 1;
+    Cycle cycle{0, 1};
+    auto tortoise = first;
+    auto hare = next(first);
+    while (!(tortoise == hare)) {
+        if (power == cycle.length) {
+            tortoise = hare;
+            power *= 2;
+            cycle.length = 0;
+        }
+        hare = next(hare);
+        ++cycle.length;
+    }
+    // then walk two states length apart until they meet at the start
+    tortoise = first;
+    hare = first;
+    for (int64_t i = 0; i < cycle.length; ++i) {
+        hare = next(hare);
+    }
+    while (!(tortoise == hare)) {
+        tortoise = next(tortoise);
+        hare = next(hare);
+        ++cycle.start;
+    }
+    return cycle;
+}
+} // namespace CycleDetect
+
+template <typename Key, size_t N> class CycleDetector {
+    struct Hash {
+        size_t operator()(const Key &key) const { return CycleDetect::hash(key); }
+    };
+    struct Equal {
+        bool operator()(const Key &a, const Key &b) const {
+            return std::memcmp(&a, &b, sizeof(Key)) == 0;
+        }
+    };
+    std::unordered_map<Key, CycleDetect::Counters<N>, Hash, Equal> seen{};
+
+  public:
+    // Remember the counters at key. If key was seen before, returns how
+    // much each counter grew since then, i.e. over one cycle.
+    std::optional<CycleDetect::Counters<N>> check(const Key &key,
+                                                  const CycleDetect::Counters<N> &counters) {
+        const auto [entry, inserted] = seen.try_emplace(key, counters);
+        if (inserted) {
+            return std::nullopt;
+        }
+        CycleDetect::Counters<N> cycle{};
+        for (size_t i = 0; i < N; ++i) {
+            cycle[i] = counters[i] - entry->second[i];
+        }
+        return cycle;
+    }
+
+    // number of keys remembered
+    size_t size() const { return seen.size(); }
+    void clear() { seen.clear(); }
+};
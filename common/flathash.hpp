@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "vec2.hpp"
+#include "vec3.hpp"
+
+// Hash set and map for Vec2 / Vec3 keys with open addressing.
+// usage:
+// FlatVecSet<Vec2l> visited{{0, 0}};
+// visited.insert(pos) - true if pos was not in the set before
+// FlatVecMap<Vec2l, char> cave{};
+// cave[pos] = '#';
+//
+// All entries live in one array with linear probing, so an insert doesn't
+// allocate a node. Elements can't be erased one by one, only by clear(),
+// which keeps the capacity. Iteration order is unspecified.
+
+namespace FlatHash {
+// finalizer of MurmurHash3, spreads every input bit over the whole word
+constexpr uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccd;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53;
+    h ^= h >> 33;
+    return h;
+}
+
+constexpr uint64_t golden = 0x9e3779b97f4a7c15;
+
+template <typename num> constexpr uint64_t hash(const Vec2<num> &v) {
+    return mix(static_cast<uint64_t>(v.x) * golden + static_cast<uint64_t>(v.y));
+}
+
+template <typename num> constexpr uint64_t hash(const Vec3<num> &v) {
+    return mix((static_cast<uint64_t>(v.x) * golden + static_cast<uint64_t>(v.y)) * golden +
+               static_cast<uint64_t>(v.z));
+}
+
+template <typename Key> constexpr const Key &keyOf(const Key &key) { return key; }
+template <typename Key, typename Value>
+constexpr const Key &keyOf(const std::pair<Key, Value> &slot) {
+    return slot.first;
+}
+
+// common part of FlatVecSet and FlatVecMap, Slot is the stored element
+template <typename Key, typename Slot> class Table {
+  protected:
+    std::vector<Slot> slots{};
+    std::vector<uint8_t> used{};
+    size_t count{0};
+
+    // slot of key, or the free slot where it belongs
+    size_t probe(const Key &key) const {
+        const size_t mask = slots.size() - 1;
+        size_t i = hash(key) & mask;
+        while (used[i] and !(keyOf<Key>(slots[i]) == key)) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void rehash(const size_t capacity) {
+        std::vector<Slot> oldSlots(capacity);
+        std::vector<uint8_t> oldUsed(capacity, 0);
+        oldSlots.swap(slots);
+        oldUsed.swap(used);
+        for (size_t i = 0; i < oldSlots.size(); ++i) {
+            if (oldUsed[i]) {
+                const auto j = probe(keyOf<Key>(oldSlots[i]));
+                slots[j] = std::move(oldSlots[i]);
+                used[j] = 1;
+            }
+        }
+    }
+
+    // slot of key and true if the slot is new, the caller fills new slots
+    std::pair<size_t, bool> claim(const Key &key) {
+        // keep the load factor below 1/2, most lookups are misses and
+        // linear probing gets slow for them on fuller tables
+        if ((count + 1) * 2 > slots.size()) {
+            rehash(std::max<size_t>(16, slots.size() * 2));
+        }
+        const auto i = probe(key);
+        if (used[i]) {
+            return {i, false};
+        }
+        used[i] = 1;
+        ++count;
+        return {i, true};
+    }
+
+  public:
+    using value_type = Slot;
+
+    class iterator {
+        const Table *table;
+        size_t i;
+
+        void skipUnused() {
+            while (i < table->used.size() and !table->used[i]) {
+                ++i;
+            }
+        }
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = Slot;
+        using pointer = const Slot *;
+        using reference = const Slot &;
+
+        iterator() : table(nullptr), i(0) {}
+        iterator(const Table *table, const size_t i) : table(table), i(i) { skipUnused(); }
+
+        reference operator*() const { return table->slots[i]; }
+        pointer operator->() const { return &table->slots[i]; }
+        iterator &operator++() {
+            ++i;
+            skipUnused();
+            return *this;
+        }
+        iterator operator++(int) {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const iterator &other) const { return i == other.i; }
+    };
+
+    iterator begin() const { return {this, 0}; }
+    iterator end() const { return {this, used.size()}; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    bool contains(const Key &key) const { return count != 0 and used[probe(key)]; }
+
+    void reserve(const size_t elements) {
+        size_t capacity = 16;
+        while (capacity < elements * 2) {
+            capacity *= 2;
+        }
+        if (capacity > slots.size()) {
+            rehash(capacity);
+        }
+    }
+
+    void clear() {
+        std::fill(used.begin(), used.end(), 0);
+        count = 0;
+    }
+};
+} // namespace FlatHash
+
+template <typename Key> class FlatVecSet : public FlatHash::Table<Key, Key> {
+    using Base = FlatHash::Table<Key, Key>;
+
+  public:
+    FlatVecSet() = default;
+    FlatVecSet(std::initializer_list<Key> keys) {
+        for (const auto &key : keys) {
+            insert(key);
+        }
+    }
+
+    // true if key was not in the set
+    bool insert(const Key &key) {
+        const auto [i, inserted] = Base::claim(key);
+        if (inserted) {
+            Base::slots[i] = key;
+        }
+        return inserted;
+    }
+
+    template <typename... Args> bool emplace(Args &&...args) {
+        return insert(Key{std::forward<Args>(args)...});
+    }
+};
+
+template <typename Key, typename Value>
+class FlatVecMap : public FlatHash::Table<Key, std::pair<Key, Value>> {
+    using Base = FlatHash::Table<Key, std::pair<Key, Value>>;
+
+  public:
+    // default constructs the value of a new key
+    Value &operator[](const Key &key) {
+        const auto [i, inserted] = Base::claim(key);
+        if (inserted) {
+            Base::slots[i] = {key, Value{}};
+        }
+        return Base::slots[i].second;
+    }
+
+    // pointer to the value of key, nullptr if key is not in the map
+    Value *find(const Key &key) {
+        return const_cast<Value *>(static_cast<const FlatVecMap *>(this)->find(key));
+    }
+    const Value *find(const Key &key) const {
+        if (Base::count == 0) {
+            return nullptr;
+        }
+        const auto i = Base::probe(key);
+        return Base::used[i] ? &Base::slots[i].second : nullptr;
+    }
+
+    const Value &at(const Key &key) const {
+        if (const auto *value = find(key)) {
+            return *value;
+        }
+        throw std::out_of_range("FlatVecMap::at");
+    }
+};
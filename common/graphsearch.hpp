@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Searches over implicit graphs, the states and their neighbours are given
+// by the caller.
+// usage:
+// GraphSearch::Visited seen{cells};       - marks for cells 0 .. cells - 1
+// GraphSearch::bfs(std::vector{start},
+//     [&](const Pos &pos, auto emit) { ... if (seen.insert(i)) emit(next); },
+//     [&](const Pos &pos, int64_t distance) { return pos == goal; });
+// GraphSearch::astar(start, expand, heuristic, isGoal)
+//     - expand calls emit(next, cost) with small integer costs
+// GraphSearch::bidirectional(start, goal, index, forward, backward, a, b)
+//
+// bfs() and astar() leave it to expand() which neighbours to emit, so the
+// caller decides what counts as seen, e.g. a position at a given time.
+// All searches return the distance or cost found, -1 if there is none.
+
+namespace GraphSearch {
+// Marks for indices 0 .. size - 1. clear() starts a new generation instead
+// of touching all marks, so a search can be repeated without reallocating
+// or refilling them.
+class Visited {
+    std::vector<uint32_t> stamps{};
+    // marks of older generations don't count
+    uint32_t generation{1};
+
+  public:
+    Visited() = default;
+    explicit Visited(const size_t size) : stamps(size) {}
+
+    size_t size() const { return stamps.size(); }
+    // new indices are unmarked
+    void resize(const size_t size) { stamps.resize(size); }
+
+    void clear() {
+        if (++generation == 0) {
+            // once every 2^32 - 1 clears
+            std::fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+    }
+
+    bool contains(const size_t index) const { return stamps[index] == generation; }
+
+    // true if index was not marked before
+    bool insert(const size_t index) {
+        if (stamps[index] == generation) {
+            return false;
+        }
+        stamps[index] = generation;
+        return true;
+    }
+};
+
+// Breadth first search from all states of level. The levels are buckets of
+// one distance each. found(state, distance) is called for every state
+// before it is expanded, returning true stops the search at that distance.
+// expand(state, emit) calls emit(next) for every neighbour not seen yet.
+template <typename State, typename Expand, typename Found>
+int64_t bfs(std::vector<State> level, Expand expand, Found found) {
+    std::vector<State> next{};
+    for (int64_t distance = 0; !level.empty(); ++distance) {
+        for (const auto &state : level) {
+            if (found(state, distance)) {
+                return distance;
+            }
+            expand(state, [&](const State &neighbour) { next.push_back(neighbour); });
+        }
+        level.swap(next);
+        next.clear();
+    }
+    return -1;
+}
+
+// A* with a bucket queue (Dial's algorithm): costs are small non-negative
+// integers and heuristic(state) must never overestimate the remaining cost
+// nor drop by more than the cost of a step. Bucket f holds the states with
+// cost + heuristic f, the last state added to the lowest bucket is expanded
+// first, which follows a promising path instead of widening all of them.
+// expand(state, emit) calls emit(next, cost) for every step worth taking,
+// isGoal(state) ends the search when the state is taken from the queue.
+// expand() runs when a state is taken from the queue, returning early for
+// states already expanded closes them like the textbook A*. Marking states
+// when they are emitted is only enough if the state fixes its cost, like a
+// position at a given minute.
+template <typename State, typename Expand, typename Heuristic, typename Goal>
+int64_t astar(const State &start, Expand expand, Heuristic heuristic, Goal isGoal) {
+    // state and its cost so far
+    std::vector<std::vector<std::pair<State, int64_t>>> buckets{};
+    const auto push = [&](const State &state, const int64_t cost) {
+        const auto f = static_cast<size_t>(cost + heuristic(state));
+        if (f >= buckets.size()) {
+            buckets.resize(f + 1);
+        }
+        buckets[f].emplace_back(state, cost);
+    };
+    push(start, 0);
+    for (auto f = static_cast<size_t>(heuristic(start)); f < buckets.size(); ++f) {
+        while (!buckets[f].empty()) {
+            const auto [state, cost] = buckets[f].back();
+            buckets[f].pop_back();
+            if (isGoal(state)) {
+                return cost;
+            }
+            expand(state,
+                   [&](const State &next, const int64_t step) { push(next, cost + step); });
+        }
+        // done with this bucket for good
+        std::vector<std::pair<State, int64_t>>{}.swap(buckets[f]);
+    }
+    return -1;
+}
+
+// Breadth first search from both ends, always widening the smaller of the
+// two frontiers by one level. forward(state, emit) and backward(state, emit)
+// call emit(next) for all neighbours along and against the edges,
+// index(state) maps a state to an index of the Visited marks. Both Visited
+// are cleared first.
+template <typename State, typename Index, typename Forward, typename Backward>
+int64_t bidirectional(const State &start, const State &goal, Index index, Forward forward,
+                      Backward backward, Visited &fromStart, Visited &fromGoal) {
+    if (index(start) == index(goal)) {
+        return 0;
+    }
+    fromStart.clear();
+    fromGoal.clear();
+    fromStart.insert(index(start));
+    fromGoal.insert(index(goal));
+    std::vector<State> startLevel{start};
+    std::vector<State> goalLevel{goal};
+    std::vector<State> next{};
+    int64_t startDistance = 0;
+    int64_t goalDistance = 0;
+
+    // widen level by one step, returns the distance if it met the other side
+    const auto widen = [&](std::vector<State> &level, auto expand, Visited &own,
+                           const Visited &other, int64_t &distance, const int64_t otherDistance) {
+        next.clear();
+        for (const auto &state : level) {
+            bool met = false;
+            expand(state, [&](const State &neighbour) {
+                const auto i = index(neighbour);
+                if (other.contains(i)) {
+                    // the other side reached it in its last level
+                    met = true;
+                } else if (own.insert(i)) {
+                    next.push_back(neighbour);
+                }
+            });
+            if (met) {
+                return distance + 1 + otherDistance;
+            }
+        }
+        level.swap(next);
+        ++distance;
+        return int64_t{-1};
+    };
+
+    while (!startLevel.empty() and !goalLevel.empty()) {
+        const auto found =
+            startLevel.size() <= goalLevel.size()
+                ? widen(startLevel, forward, fromStart, fromGoal, startDistance, goalDistance)
+                : widen(goalLevel, backward, fromGoal, fromStart, goalDistance, startDistance);
+        if (found >= 0) {
+            return found;
+        }
+    }
+    return -1;
+}
+} // namespace GraphSearch
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "vec2.hpp"
+#include "wholefile.hpp"
+
+// Rectangular grid in one contiguous allocation.
+// usage:
+// auto map = loadGrid(argv[1]);            - Grid2D<char> of the input file
+// Grid2D<int64_t> dist{map.size(), -1, 1}; - same size, with a border of 1
+// map[Vec2l{x, y}]                         - cell, (0, 0) is the top left
+//
+// Cells outside the grid are accessible up to border() cells away, they are
+// set to borderValue. A sentinel border lets inner loops look at neighbours
+// without checking the bounds. Rows are padded to whole cache lines.
+template <typename T> class Grid2D {
+    // std::vector<bool> has no T&, use uint8_t instead
+    static_assert(!std::is_same_v<T, bool>);
+
+    static constexpr size_t rowAlign = sizeof(T) < 64 and 64 % sizeof(T) == 0 ? 64 / sizeof(T) : 1;
+
+    int64_t gridWidth{0};
+    int64_t gridHeight{0};
+    int64_t gridBorder{0};
+    int64_t rowStride{0};
+    std::vector<T> cells{};
+
+  public:
+    Grid2D() = default;
+
+    Grid2D(const Vec2z size, const T &fill = {}, const size_t border = 0,
+           const T &borderValue = {})
+        : gridWidth(static_cast<int64_t>(size.x)), gridHeight(static_cast<int64_t>(size.y)),
+          gridBorder(static_cast<int64_t>(border)) {
+        const auto paddedWidth = size.x + 2 * border;
+        rowStride = static_cast<int64_t>((paddedWidth + rowAlign - 1) / rowAlign * rowAlign);
+        cells.assign(static_cast<size_t>(rowStride) * (size.y + 2 * border), borderValue);
+        for (int64_t y = 0; y < gridHeight; ++y) {
+            std::fill_n(row(y), gridWidth, fill);
+        }
+    }
+
+    int64_t width() const { return gridWidth; }
+    int64_t height() const { return gridHeight; }
+    int64_t border() const { return gridBorder; }
+    // distance between two rows in cells
+    int64_t stride() const { return rowStride; }
+    Vec2z size() const { return {static_cast<size_t>(gridWidth), static_cast<size_t>(gridHeight)}; }
+
+    // true if pos is inside the grid, not in the border
+    template <typename num> bool contains(const Vec2<num> &pos) const {
+        const auto x = static_cast<int64_t>(pos.x);
+        const auto y = static_cast<int64_t>(pos.y);
+        return x >= 0 and y >= 0 and x < gridWidth and y < gridHeight;
+    }
+
+    // first cell of row y, row(y)[-1] is in the border
+    T *row(const int64_t y) { return cells.data() + offset(0, y); }
+    const T *row(const int64_t y) const { return cells.data() + offset(0, y); }
+
+    template <typename num> T &operator[](const Vec2<num> &pos) {
+        return cells[offset(static_cast<int64_t>(pos.x), static_cast<int64_t>(pos.y))];
+    }
+    template <typename num> const T &operator[](const Vec2<num> &pos) const {
+        return cells[offset(static_cast<int64_t>(pos.x), static_cast<int64_t>(pos.y))];
+    }
+
+    // position of the first cell equal to value, row by row
+    std::optional<Vec2l> find(const T &value) const {
+        for (int64_t y = 0; y < gridHeight; ++y) {
+            const auto *begin = row(y);
+            const auto *found = std::find(begin, begin + gridWidth, value);
+            if (found != begin + gridWidth) {
+                return Vec2l{found - begin, y};
+            }
+        }
+        return std::nullopt;
+    }
+
+  private:
+    size_t offset(const int64_t x, const int64_t y) const {
+        return static_cast<size_t>((y + gridBorder) * rowStride + x + gridBorder);
+    }
+};
+
+// Load the grid at the start of a file, one row per line. The grid ends at
+// the first empty line or the end of the file. The width is the longest
+// line, shorter lines are filled up with borderValue.
+// convert(char) -> T translates the characters, i.e. '0'..'9' to numbers.
+template <typename T = char, typename Convert = std::identity>
+Grid2D<T> loadGrid(const char *filename, const size_t border = 0, const T &borderValue = {},
+                   Convert convert = {}) {
+    const WholeFile input{filename};
+    const auto text = input.view();
+
+    // find the lines and the width first, then fill the grid
+    std::vector<std::string_view> lines{};
+    size_t width = 0;
+    for (size_t pos = 0; pos < text.size();) {
+        const auto newline = std::min(text.find('\n', pos), text.size());
+        if (newline == pos) {
+            break;
+        }
+        lines.push_back(text.substr(pos, newline - pos));
+        width = std::max(width, newline - pos);
+        pos = newline + 1;
+    }
+
+    Grid2D<T> grid{{width, lines.size()}, borderValue, border, borderValue};
+    for (int64_t y = 0; y < grid.height(); ++y) {
+        const auto line = lines[static_cast<size_t>(y)];
+        if constexpr (std::is_same_v<T, char> and std::is_same_v<Convert, std::identity>) {
+            std::memcpy(grid.row(y), line.data(), line.size());
+        } else {
+            std::transform(line.begin(), line.end(), grid.row(y), convert);
+        }
+    }
+    return grid;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Set of integers stored as sorted, disjoint closed intervals [from, to].
+// usage:
+// IntervalSet covered{};
+// covered.insert(from, to);          - merges with overlapping intervals
+// covered.insert(batch);             - many at once: sort and sweep
+// covered.length()                   - number of integers in the set
+// for (const auto gap : covered.gaps(0, limit)) ...
+//
+// The intervals live in one std::vector, clear() keeps the capacity, so
+// filling the same set again for every row of a puzzle doesn't allocate.
+// Intervals that touch, like [1, 3] and [4, 6], are merged into one.
+
+struct Interval {
+    int64_t from;
+    int64_t to;
+
+    int64_t length() const { return to - from + 1; }
+    bool operator==(const Interval &) const = default;
+};
+
+class IntervalSet {
+    // sorted by from, with at least one integer between neighbours
+    std::vector<Interval> spans{};
+
+    // merge all overlapping or touching intervals, spans must be sorted
+    void sweep() {
+        if (spans.empty()) {
+            return;
+        }
+        auto last = spans.begin();
+        for (auto next = spans.begin() + 1; next != spans.end(); ++next) {
+            if (next->from <= last->to + 1) {
+                last->to = std::max(last->to, next->to);
+            } else {
+                *++last = *next;
+            }
+        }
+        spans.erase(last + 1, spans.end());
+    }
+
+  public:
+    using const_iterator = std::vector<Interval>::const_iterator;
+
+    IntervalSet() = default;
+    explicit IntervalSet(const std::span<const Interval> intervals) { insert(intervals); }
+
+    // add [from, to], from <= to
+    void insert(const int64_t from, const int64_t to) {
+        // first interval not ending before from - 1, and the first one
+        // starting after to + 1, everything in between is merged
+        auto first = std::lower_bound(spans.begin(), spans.end(), from,
+                                      [](const Interval &span, const int64_t value) {
+                                          return span.to + 1 < value;
+                                      });
+        auto last = std::upper_bound(first, spans.end(), to,
+                                     [](const int64_t value, const Interval &span) {
+                                         return value + 1 < span.from;
+                                     });
+        if (first == last) {
+            spans.insert(first, {from, to});
+            return;
+        }
+        first->from = std::min(first->from, from);
+        first->to = std::max((last - 1)->to, to);
+        spans.erase(first + 1, last);
+    }
+
+    // add many intervals at once, in any order
+    void insert(const std::span<const Interval> intervals) {
+        spans.insert(spans.end(), intervals.begin(), intervals.end());
+        std::sort(spans.begin(), spans.end(),
+                  [](const Interval &a, const Interval &b) { return a.from < b.from; });
+        sweep();
+    }
+
+    // keep only the part inside [from, to]
+    void clip(const int64_t from, const int64_t to) {
+        std::erase_if(spans,
+                      [&](const Interval &span) { return span.to < from or span.from > to; });
+        if (!spans.empty()) {
+            spans.front().from = std::max(spans.front().from, from);
+            spans.back().to = std::min(spans.back().to, to);
+        }
+    }
+
+    // the integers of [from, to] not in the set, as sorted intervals
+    std::vector<Interval> gaps(const int64_t from, const int64_t to) const {
+        std::vector<Interval> result{};
+        auto next = from;
+        for (const auto &span : spans) {
+            if (span.to < next) {
+                continue;
+            }
+            if (span.from > to) {
+                break;
+            }
+            if (span.from > next) {
+                result.push_back({next, span.from - 1});
+            }
+            next = span.to + 1;
+        }
+        if (next <= to) {
+            result.push_back({next, to});
+        }
+        return result;
+    }
+
+    bool contains(const int64_t value) const {
+        const auto span = std::lower_bound(
+            spans.begin(), spans.end(), value,
+            [](const Interval &interval, const int64_t v) { return interval.to < v; });
+        return span != spans.end() and span->from <= value;
+    }
+
+    // number of integers in the set
+    int64_t length() const {
+        int64_t total = 0;
+        for (const auto &span : spans) {
+            total += span.length();
+        }
+        return total;
+    }
+
+    // number of disjoint intervals
+    size_t size() const { return spans.size(); }
+    bool empty() const { return spans.empty(); }
+    void clear() { spans.clear(); }
+
+    const_iterator begin() const { return spans.begin(); }
+    const_iterator end() const { return spans.end(); }
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+// Read-only memory mapping of a whole file.
+// isMapped() is false if the file can't be opened or mapped, i.e. for empty
+// files or pipes; the caller has to fall back to reading a stream then.
+class MappedFile {
+    const char *data{nullptr};
+    size_t size{0};
+
+  public:
+    MappedFile() = default;
+
+    MappedFile(const char *filename) {
+        const int fd = ::open(filename, O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+            const auto length = static_cast<size_t>(info.st_size);
+            void *addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                ::madvise(addr, length, MADV_SEQUENTIAL);
+                data = static_cast<const char *>(addr);
+                size = length;
+            }
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept
+        : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {}
+    MappedFile &operator=(MappedFile &&other) noexcept {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+        return *this;
+    }
+
+    ~MappedFile() {
+        if (data != nullptr) {
+            ::munmap(const_cast<char *>(data), size);
+        }
+    }
+
+    bool isMapped() const { return data != nullptr; }
+    std::string_view view() const { return {data, size}; }
+};
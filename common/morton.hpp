@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "vec2.hpp"
+#include "vec3.hpp"
+
+// Morton (Z-order) codes: the bits of the coordinates interleaved into one
+// uint64_t, so points close in space get close codes.
+// usage:
+// const auto code = Morton::encode(Vec3i{x, y, z});
+// Morton::decode3(code) == Vec3i{x, y, z}
+// Morton::inc<Morton::x3>(code) - code of {x + 1, y, z}
+//
+// Vec2i uses the full int32_t range, Vec3i coordinates have to fit into
+// 21 bits, i.e. [-2^20, 2^20). Signed coordinates are biased to unsigned
+// ones first, so the order along one axis is kept.
+// interleave2() / interleave3() encode unsigned coordinates without bias.
+
+namespace Morton {
+// lanes of each coordinate in a code
+constexpr uint64_t x2 = 0x5555555555555555;
+constexpr uint64_t y2 = x2 << 1;
+constexpr uint64_t x3 = 0x1249249249249249;
+constexpr uint64_t y3 = x3 << 1;
+constexpr uint64_t z3 = x3 << 2;
+
+constexpr int64_t bias2 = int64_t{1} << 31;
+constexpr int64_t bias3 = int64_t{1} << 20;
+
+// 32 bits to every other bit
+constexpr uint64_t spread2(const uint64_t v) {
+    uint64_t x = v & 0xffffffff;
+    x = (x | x << 16) & 0x0000ffff0000ffff;
+    x = (x | x << 8) & 0x00ff00ff00ff00ff;
+    x = (x | x << 4) & 0x0f0f0f0f0f0f0f0f;
+    x = (x | x << 2) & 0x3333333333333333;
+    x = (x | x << 1) & 0x5555555555555555;
+    return x;
+}
+
+constexpr uint64_t compact2(const uint64_t v) {
+    uint64_t x = v & 0x5555555555555555;
+    x = (x | x >> 1) & 0x3333333333333333;
+    x = (x | x >> 2) & 0x0f0f0f0f0f0f0f0f;
+    x = (x | x >> 4) & 0x00ff00ff00ff00ff;
+    x = (x | x >> 8) & 0x0000ffff0000ffff;
+    x = (x | x >> 16) & 0x00000000ffffffff;
+    return x;
+}
+
+// 21 bits to every third bit
+constexpr uint64_t spread3(const uint64_t v) {
+    uint64_t x = v & 0x1fffff;
+    x = (x | x << 32) & 0x001f00000000ffff;
+    x = (x | x << 16) & 0x001f0000ff0000ff;
+    x = (x | x << 8) & 0x100f00f00f00f00f;
+    x = (x | x << 4) & 0x10c30c30c30c30c3;
+    x = (x | x << 2) & 0x1249249249249249;
+    return x;
+}
+
+constexpr uint64_t compact3(const uint64_t v) {
+    uint64_t x = v & 0x1249249249249249;
+    x = (x | x >> 2) & 0x10c30c30c30c30c3;
+    x = (x | x >> 4) & 0x100f00f00f00f00f;
+    x = (x | x >> 8) & 0x001f0000ff0000ff;
+    x = (x | x >> 16) & 0x001f00000000ffff;
+    x = (x | x >> 32) & 0x00000000001fffff;
+    return x;
+}
+
+constexpr uint64_t interleave2(const uint64_t x, const uint64_t y) {
+    return spread2(x) | spread2(y) << 1;
+}
+
+constexpr uint64_t interleave3(const uint64_t x, const uint64_t y, const uint64_t z) {
+    return spread3(x) | spread3(y) << 1 | spread3(z) << 2;
+}
+
+template <typename num> constexpr uint64_t encode(const Vec2<num> &v) {
+    return interleave2(static_cast<uint64_t>(static_cast<int64_t>(v.x) + bias2),
+                       static_cast<uint64_t>(static_cast<int64_t>(v.y) + bias2));
+}
+
+template <typename num> constexpr uint64_t encode(const Vec3<num> &v) {
+    return interleave3(static_cast<uint64_t>(static_cast<int64_t>(v.x) + bias3),
+                       static_cast<uint64_t>(static_cast<int64_t>(v.y) + bias3),
+                       static_cast<uint64_t>(static_cast<int64_t>(v.z) + bias3));
+}
+
+constexpr Vec2i decode2(const uint64_t code) {
+    return {static_cast<int32_t>(static_cast<int64_t>(compact2(code)) - bias2),
+            static_cast<int32_t>(static_cast<int64_t>(compact2(code >> 1)) - bias2)};
+}
+
+constexpr Vec3i decode3(const uint64_t code) {
+    return {static_cast<int32_t>(static_cast<int64_t>(compact3(code)) - bias3),
+            static_cast<int32_t>(static_cast<int64_t>(compact3(code >> 1)) - bias3),
+            static_cast<int32_t>(static_cast<int64_t>(compact3(code >> 2)) - bias3)};
+}
+
+// Add a spread value (i.e. spread3(5) << 1 for y + 5) to the lane of a code
+// without decoding it. The carry runs through the bits of the other lanes,
+// which are set to 1 for that.
+constexpr uint64_t add(const uint64_t code, const uint64_t lane, const uint64_t value) {
+    return (((code | ~lane) + (value & lane)) & lane) | (code & ~lane);
+}
+
+constexpr uint64_t sub(const uint64_t code, const uint64_t lane, const uint64_t value) {
+    return (((code & lane) - (value & lane)) & lane) | (code & ~lane);
+}
+
+// neighbour in one direction, lane is one of x2, y2, x3, y3, z3
+template <uint64_t lane> constexpr uint64_t inc(const uint64_t code) {
+    return add(code, lane, lane & -lane);
+}
+
+template <uint64_t lane> constexpr uint64_t dec(const uint64_t code) {
+    return sub(code, lane, lane & -lane);
+}
+
+// Z-order of Vec2 / Vec3, i.e. std::set<Vec3i, Morton::Less>
+struct Less {
+    template <typename Vec> constexpr bool operator()(const Vec &a, const Vec &b) const {
+        return encode(a) < encode(b);
+    }
+};
+
+// Morton codes are well distributed in the low bits for dense point sets,
+// i.e. std::unordered_set<Vec3i, Morton::Hash>
+struct Hash {
+    template <typename Vec> constexpr size_t operator()(const Vec &v) const {
+        return static_cast<size_t>(encode(v));
+    }
+};
+
+static_assert(decode2(encode(Vec2i{-3, 7})) == Vec2i{-3, 7});
+static_assert(decode3(encode(Vec3i{-3, 7, 1048575})) == Vec3i{-3, 7, 1048575});
+static_assert(inc<x3>(encode(Vec3i{-1, 2, 3})) == encode(Vec3i{0, 2, 3}));
+static_assert(dec<z3>(encode(Vec3i{1, 2, 0})) == encode(Vec3i{1, 2, -1}));
+static_assert(Less{}(Vec2i{1, 1}, Vec2i{2, 2}));
+} // namespace Morton
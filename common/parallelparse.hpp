@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <future>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "profiler.hpp"
+#include "wholefile.hpp"
+
+// Parse a file with one thread per chunk.
+// usage:
+// parallelParse(filename, Records::lines, parseChunk, merge)
+//   - parseChunk(std::string_view chunk) -> Result runs once per chunk,
+//     every chunk starts and ends on a record boundary
+//   - merge(Result &into, Result &&chunk) is called in file order
+//   - returns the merged Result
+// filename "-" reads all of stdin first.
+// The input only lives during parallelParse(), results must not keep views
+// into a chunk.
+
+enum class Records {
+    lines, // records end with a newline
+    blocks // records are groups of lines, separated by an empty line
+};
+
+// Split input into at most count chunks of about the same size
+inline std::vector<std::string_view> splitRecords(std::string_view input, const size_t count,
+                                                  const Records records) {
+    const std::string_view separator = (records == Records::lines) ? "\n" : "\n\n";
+    std::vector<std::string_view> chunks{};
+    size_t start = 0;
+    for (size_t i = 1; i <= count and start < input.size(); ++i) {
+        size_t end = input.size();
+        if (i < count) {
+            // the separator may start right before the target position
+            const auto target = std::max(start, input.size() * i / count);
+            const auto found = input.find(separator, std::max(target, size_t{1}) - 1);
+            if (found != input.npos) {
+                end = std::max(start, found + separator.size());
+            }
+        }
+        if (end > start) {
+            chunks.push_back(input.substr(start, end - start));
+        }
+        start = end;
+    }
+    return chunks;
+}
+
+// Call fn for every line of a chunk, without the newline
+inline void forEachLine(std::string_view chunk, auto fn) {
+    while (!chunk.empty()) {
+        const auto newline = chunk.find('\n');
+        fn(chunk.substr(0, newline));
+        if (newline == chunk.npos) {
+            break;
+        }
+        chunk.remove_prefix(newline + 1);
+    }
+}
+
+// chunks smaller than this are not worth a thread
+constexpr size_t minChunkSize = 1 << 20;
+
+template <typename ParseChunk, typename Merge>
+auto parallelParse(const char *filename, const Records records, ParseChunk parseChunk,
+                   Merge merge, size_t threads = std::thread::hardware_concurrency())
+    -> std::invoke_result_t<ParseChunk, std::string_view> {
+    using Result = std::invoke_result_t<ParseChunk, std::string_view>;
+
+    const WholeFile wholeFile{filename};
+    const auto input = wholeFile.view();
+
+    threads = std::clamp<size_t>(input.size() / minChunkSize, 1, std::max<size_t>(threads, 1));
+    std::vector<std::future<Result>> taskpool{};
+    for (const auto chunk : splitRecords(input, threads, records)) {
+        taskpool.push_back(std::async(std::launch::async, [&parseChunk, chunk] {
+            ScopedTimer timer{"parseChunk"};
+            return parseChunk(chunk);
+        }));
+    }
+
+    Result result{};
+    for (auto &task : taskpool) {
+        auto chunkResult = task.get();
+        ScopedTimer timer{"merge"};
+        merge(result, std::move(chunkResult));
+    }
+    return result;
+}
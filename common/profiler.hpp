@@ -0,0 +1,494 @@
+#pragma once
+
+// Nested timers that add up over repeated calls and threads and print a
+// table to stderr when the program ends.
+// usage:
+// {
+//     ScopedTimer timer{"parse"};        - times the rest of the scope
+//     ...
+//     { ScopedTimer inner{"line"}; ... } - shows up as parse/line
+// }
+//
+// Only compiled in with -DPROFILE (make PROFILE=1 after a make clean),
+// otherwise ScopedTimer is empty and the timers vanish from hot loops.
+// Timers of the same name below the same parent are one entry, a function
+// calling itself counts its calls but is only timed by the outermost call.
+// With PROFILE_JSON=file in the environment the tree is written to file as
+// JSON instead of the table.
+//
+// PerfRegion region{"flood"};           - a ScopedTimer that also counts
+//                                         cycles, instructions, cache and
+//                                         branch misses of its thread
+// The counters come from perf_event_open, where that fails (not Linux,
+// kernel.perf_event_paranoid, no PMU in a VM) PerfRegion only times and
+// the report says so.
+//
+// A program that includes allocationcounter.hpp (in one file only) also
+// gets the allocations, their bytes and the peak of live bytes above the
+// start of each timer in the report.
+//
+// With PROFILE_TRACE=file the outermost call of every timer is also a span
+// on the timeline of its thread, written as trace event JSON for Perfetto
+// or chrome://tracing, with the live bytes of each thread as a counter.
+// Threads still running at exit are missing.
+
+#ifdef PROFILE
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fmt/format.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Profile {
+// cycles, instructions, cache misses, branch misses
+using Counters = std::array<uint64_t, 4>;
+
+// counted by the operator new of allocationcounter.hpp for each thread
+struct Allocations {
+    int64_t count{0};
+    int64_t bytes{0};
+    int64_t live{0};
+    // most bytes live since the innermost timer started
+    int64_t peak{0};
+    // inside the profiler itself, not counted
+    int64_t ignore{0};
+};
+
+inline thread_local Allocations allocations{};
+
+struct Node {
+    const char *name;
+    int64_t calls{0};
+    int64_t nanoseconds{0};
+    // set by a PerfRegion that could read the counters
+    bool counted{false};
+    Counters counters{};
+    int64_t allocations{0};
+    int64_t bytes{0};
+    // most bytes live at once above those live when the timer started
+    int64_t peakBytes{0};
+    // timers of this name running in this thread, only the outermost counts
+    int64_t active{0};
+    std::vector<std::unique_ptr<Node>> children{};
+
+    explicit Node(const char *nodeName) : name(nodeName) {}
+
+    Node &child(const char *childName) {
+        for (auto &node : children) {
+            // mostly the same literal, strcmp for the same name elsewhere
+            if (node->name == childName or std::strcmp(node->name, childName) == 0) {
+                return *node;
+            }
+        }
+        return *children.emplace_back(std::make_unique<Node>(childName));
+    }
+
+    void merge(const Node &other) {
+        calls += other.calls;
+        nanoseconds += other.nanoseconds;
+        counted = counted or other.counted;
+        allocations += other.allocations;
+        bytes += other.bytes;
+        peakBytes = std::max(peakBytes, other.peakBytes);
+        for (size_t i = 0; i < counters.size(); ++i) {
+            counters[i] += other.counters[i];
+        }
+        for (const auto &node : other.children) {
+            child(node->name).merge(*node);
+        }
+    }
+};
+
+inline bool anyCounted(const Node &node) {
+    return node.counted or std::ranges::any_of(node.children, [](const auto &child) {
+               return anyCounted(*child);
+           });
+}
+
+inline bool anyAllocated(const Node &node) {
+    return node.allocations > 0 or std::ranges::any_of(node.children, [](const auto &child) {
+               return anyAllocated(*child);
+           });
+}
+
+inline void printTable(const Node &node, const int64_t parentNanoseconds, const size_t depth,
+                       const bool allocated) {
+    const auto label = std::string(2 * depth, ' ') + node.name;
+    const auto percent = parentNanoseconds > 0 ? 100. * double(node.nanoseconds) /
+                                                     double(parentNanoseconds)
+                                               : 100.;
+    fmt::print(stderr, "{:32s} {:10} {:12.3f} {:10.3f} {:6.1f}%", label, node.calls,
+               double(node.nanoseconds) / 1e6,
+               double(node.nanoseconds) / 1e3 / double(node.calls), percent);
+    if (allocated) {
+        fmt::print(stderr, " {:10} {:12} {:12}", node.allocations, node.bytes, node.peakBytes);
+    }
+    if (node.counted) {
+        const auto &[cycles, instructions, cacheMisses, branchMisses] = node.counters;
+        fmt::print(stderr, " {:14} {:6.2f} {:12} {:12}", cycles,
+                   cycles > 0 ? double(instructions) / double(cycles) : 0., cacheMisses,
+                   branchMisses);
+    }
+    fmt::print(stderr, "\n");
+    for (const auto &child : node.children) {
+        printTable(*child, node.nanoseconds, depth + 1, allocated);
+    }
+}
+
+inline std::string toJson(const Node &node) {
+    std::string children{};
+    for (const auto &child : node.children) {
+        if (!children.empty()) {
+            children += ',';
+        }
+        children += toJson(*child);
+    }
+    const auto &[cycles, instructions, cacheMisses, branchMisses] = node.counters;
+    const auto counters =
+        node.counted ? fmt::format(R"("cycles":{},"instructions":{},"cacheMisses":{},)"
+                                   R"("branchMisses":{},)",
+                                   cycles, instructions, cacheMisses, branchMisses)
+                     : std::string{};
+    const auto allocated =
+        node.allocations > 0
+            ? fmt::format(R"("allocations":{},"bytes":{},"peakBytes":{},)", node.allocations,
+                          node.bytes, node.peakBytes)
+            : std::string{};
+    return fmt::format(R"({{"name":"{}","calls":{},"ms":{:.6f},{}{}"children":[{}]}})",
+                       node.name, node.calls, double(node.nanoseconds) / 1e6, counters,
+                       allocated, children);
+}
+
+// the timers of all threads that ended, reported at exit
+// outermost call of a timer, for the trace
+struct Span {
+    const char *name;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+    int64_t allocations;
+    // bytes live in the thread at the end
+    int64_t live;
+};
+
+// spans kept per thread, the rest are dropped
+constexpr size_t maxSpans = 1 << 20;
+
+struct Report {
+    std::mutex lock{};
+    Node root{"total"};
+    // a PerfRegion ran without counters
+    std::atomic<bool> uncounted{false};
+    // trace file, nullptr if there is no trace
+    const char *tracePath{std::getenv("PROFILE_TRACE")};
+    const std::chrono::steady_clock::time_point epoch{std::chrono::steady_clock::now()};
+    std::atomic<int64_t> threads{0};
+    std::vector<std::string> traceEvents{};
+
+    void merge(const Node &tree, const int64_t thread, const std::vector<Span> &spans,
+               const int64_t dropped) {
+        const std::lock_guard guard{lock};
+        root.merge(tree);
+        if (tracePath == nullptr) {
+            return;
+        }
+        const auto micros = [&](const auto time) {
+            return double(std::chrono::duration_cast<std::chrono::nanoseconds>(time - epoch)
+                              .count()) /
+                   1e3;
+        };
+        traceEvents.push_back(fmt::format(
+            R"({{"name":"thread_name","ph":"M","pid":1,"tid":{0},"args":{{"name":"thread {0}"}}}})",
+            thread));
+        for (const auto &span : spans) {
+            traceEvents.push_back(fmt::format(
+                R"({{"name":"{}","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f},)"
+                R"("args":{{"allocations":{}}}}})",
+                span.name, thread, micros(span.start), micros(span.end) - micros(span.start),
+                span.allocations));
+            if (span.live != 0) {
+                traceEvents.push_back(fmt::format(
+                    R"({{"name":"live bytes","ph":"C","pid":1,"ts":{:.3f},)"
+                    R"("args":{{"thread {}":{}}}}})",
+                    micros(span.end), thread, span.live));
+            }
+        }
+        if (dropped > 0) {
+            fmt::print(stderr, "trace: thread {} dropped {} spans\n", thread, dropped);
+        }
+    }
+
+    ~Report() {
+        if (tracePath != nullptr and !traceEvents.empty()) {
+            std::ofstream out{tracePath};
+            out << "{\"traceEvents\":[\n";
+            for (size_t i = 0; i < traceEvents.size(); ++i) {
+                out << traceEvents[i] << (i + 1 < traceEvents.size() ? ",\n" : "\n");
+            }
+            out << "],\"displayTimeUnit\":\"ms\"}\n";
+        }
+        if (root.children.empty()) {
+            return;
+        }
+        if (const auto *path = std::getenv("PROFILE_JSON")) {
+            std::ofstream{path} << toJson(root) << '\n';
+            return;
+        }
+        const bool allocated = anyAllocated(root);
+        fmt::print(stderr, "{:32s} {:>10} {:>12} {:>10} {:>7}", "profile", "calls", "ms",
+                   "us/call", "parent");
+        if (allocated) {
+            fmt::print(stderr, " {:>10} {:>12} {:>12}", "allocs", "bytes", "peak bytes");
+        }
+        if (anyCounted(root)) {
+            fmt::print(stderr, " {:>14} {:>6} {:>12} {:>12}", "cycles", "IPC", "cache misses",
+                       "branch misses");
+        }
+        fmt::print(stderr, "\n");
+        if (uncounted) {
+            fmt::print(stderr, "hardware counters unavailable, PerfRegion only timed\n");
+        }
+        for (const auto &child : root.children) {
+            printTable(*child, 0, 0, allocated);
+        }
+    }
+};
+
+inline Report &report() {
+    static Report instance{};
+    return instance;
+}
+
+// the timers of one thread, merged into the report when the thread ends
+struct ThreadTree {
+    Node root{"thread"};
+    Node *current{&root};
+    // construct the report first, so it is destroyed after the main thread
+    const int64_t thread{report().threads++};
+    const bool tracing{report().tracePath != nullptr};
+    std::vector<Span> spans{};
+    int64_t dropped{0};
+
+    ~ThreadTree() { report().merge(root, thread, spans, dropped); }
+
+    void record(const Span &span) {
+        if (spans.size() == maxSpans) {
+            ++dropped;
+            return;
+        }
+        // the profiler's own allocation
+        ++allocations.ignore;
+        spans.push_back(span);
+        --allocations.ignore;
+    }
+};
+
+inline ThreadTree &threadTree() {
+    thread_local ThreadTree tree{};
+    return tree;
+}
+
+// The four counters of the calling thread as one perf event group, so they
+// are read together. Counters the kernel refuses are left out and read as
+// 0, with none at all read() fails.
+class CounterGroup {
+    // leader first, -1 if not opened
+    std::array<int, 4> fds{-1, -1, -1, -1};
+    // position of each counter in a group read
+    std::array<size_t, 4> slots{};
+    size_t opened{0};
+
+  public:
+    CounterGroup() {
+#if defined(__linux__)
+        const std::array<std::pair<uint32_t, uint64_t>, 4> events{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        }};
+        int leader = -1;
+        for (size_t i = 0; i < events.size(); ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            // this thread on any cpu
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fds[i] < 0) {
+                continue;
+            }
+            if (leader < 0) {
+                leader = fds[i];
+            }
+            slots[i] = opened++;
+        }
+#endif
+    }
+
+    ~CounterGroup() {
+#if defined(__linux__)
+        for (const auto fd : fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    CounterGroup(const CounterGroup &) = delete;
+    CounterGroup &operator=(const CounterGroup &) = delete;
+
+    // counters since the group was opened, false if they can't be read
+    bool read(Counters &counters) const {
+#if defined(__linux__)
+        int leader = -1;
+        for (const auto fd : fds) {
+            if (fd >= 0) {
+                leader = fd;
+                break;
+            }
+        }
+        // number of counters, then their values
+        std::array<uint64_t, 5> values{};
+        if (leader < 0 or ::read(leader, values.data(), sizeof(values)) <= 0) {
+            return false;
+        }
+        for (size_t i = 0; i < fds.size(); ++i) {
+            counters[i] = fds[i] >= 0 ? values[1 + slots[i]] : 0;
+        }
+        return true;
+#else
+        (void)counters;
+        return false;
+#endif
+    }
+};
+
+inline CounterGroup &counterGroup() {
+    thread_local CounterGroup group{};
+    return group;
+}
+} // namespace Profile
+
+class ScopedTimer {
+    Profile::ThreadTree &tree;
+    Profile::Node *parent;
+    Profile::Node *node;
+    std::chrono::steady_clock::time_point start{};
+    // allocations when the timer started, and the peak of the scope around
+    Profile::Allocations before{};
+
+    static Profile::Node *enter(Profile::Node *parent, const char *name) {
+        if (parent->name == name or std::strcmp(parent->name, name) == 0) {
+            return parent;
+        }
+        // a new entry is the profiler's allocation
+        ++Profile::allocations.ignore;
+        auto *node = &parent->child(name);
+        --Profile::allocations.ignore;
+        return node;
+    }
+
+  public:
+    explicit ScopedTimer(const char *name)
+        : tree(Profile::threadTree()), parent(tree.current), node(enter(parent, name)) {
+        ++node->calls;
+        if (node->active++ == 0) {
+            auto &allocations = Profile::allocations;
+            before = allocations;
+            allocations.peak = allocations.live;
+            start = std::chrono::steady_clock::now();
+        }
+        tree.current = node;
+    }
+
+    ~ScopedTimer() {
+        if (--node->active == 0) {
+            const auto end = std::chrono::steady_clock::now();
+            node->nanoseconds +=
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            auto &allocations = Profile::allocations;
+            node->allocations += allocations.count - before.count;
+            node->bytes += allocations.bytes - before.bytes;
+            node->peakBytes = std::max(node->peakBytes, allocations.peak - before.live);
+            allocations.peak = std::max(allocations.peak, before.peak);
+            if (tree.tracing) {
+                tree.record({node->name, start, end, allocations.count - before.count,
+                             allocations.live});
+            }
+        }
+        tree.current = parent;
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    Profile::Node &entry() const { return *node; }
+};
+
+class PerfRegion {
+    // opened before the timer starts, the first region doesn't time that
+    Profile::CounterGroup &group;
+    ScopedTimer timer;
+    Profile::Counters start{};
+    // the outermost region of its name that could read the counters
+    bool counting{false};
+
+  public:
+    explicit PerfRegion(const char *name) : group(Profile::counterGroup()), timer(name) {
+        if (timer.entry().active == 1) {
+            counting = group.read(start);
+            if (!counting) {
+                Profile::report().uncounted = true;
+            }
+        }
+    }
+
+    ~PerfRegion() {
+        Profile::Counters end{};
+        if (counting and group.read(end)) {
+            auto &node = timer.entry();
+            node.counted = true;
+            for (size_t i = 0; i < end.size(); ++i) {
+                node.counters[i] += end[i] - start[i];
+            }
+        }
+    }
+
+    PerfRegion(const PerfRegion &) = delete;
+    PerfRegion &operator=(const PerfRegion &) = delete;
+};
+
+#else
+
+class ScopedTimer {
+  public:
+    explicit ScopedTimer(const char *) {}
+};
+
+class PerfRegion {
+  public:
+    explicit PerfRegion(const char *) {}
+};
+
+#endif
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "profiler.hpp"
+
+// Reads a file descriptor (i.e. a pipe on stdin) in a background thread.
+// usage:
+// ReadAhead input{STDIN_FILENO};
+// while (input.getline(line)) { ... }
+//
+// Two chunks are double buffered: the thread fills one while the caller
+// parses the other, so reading overlaps parsing. A read error is rethrown
+// as std::system_error from getline() / next().
+class ReadAhead {
+  public:
+    static constexpr size_t chunkSize = 4 << 20;
+
+  private:
+    struct Chunk {
+        std::vector<char> data = std::vector<char>(chunkSize);
+        size_t size{0};
+        bool full{false};
+    };
+
+    const int fd;
+    std::array<Chunk, 2> chunks{};
+    std::mutex mutex{};
+    std::condition_variable changed{};
+    bool stop{false};
+    int error{0};
+
+    // chunk held by the caller, and the unread rest of it
+    size_t current{1};
+    bool holding{false};
+    std::string_view rest{};
+    bool finished{false};
+
+    std::thread reader;
+
+    // wait until fd is readable, returns false if the reader has to stop
+    bool waitReadable() {
+        while (true) {
+            {
+                const std::lock_guard lock{mutex};
+                if (stop) {
+                    return false;
+                }
+            }
+            // wake up now and then, the destructor may run before EOF
+            if (readable(100)) {
+                return true;
+            }
+        }
+    }
+
+    bool readable(const int timeout) {
+        pollfd poller{fd, POLLIN, 0};
+        const int ready = ::poll(&poller, 1, timeout);
+        return ready > 0 or (ready < 0 and errno != EINTR);
+    }
+
+    // Fill chunk with what can be read without waiting once some data has
+    // arrived, so a slow writer doesn't hold back complete lines.
+    // 0 bytes means EOF.
+    size_t fill(Chunk &chunk) {
+        size_t size = 0;
+        while (size < chunkSize and (size == 0 ? waitReadable() : readable(0))) {
+            const auto got = ::read(fd, chunk.data.data() + size, chunkSize - size);
+            if (got < 0 and errno == EINTR) {
+                continue;
+            }
+            if (got < 0) {
+                const std::lock_guard lock{mutex};
+                error = errno;
+                break;
+            }
+            if (got == 0) {
+                break;
+            }
+            size += static_cast<size_t>(got);
+        }
+        return size;
+    }
+
+    void run() {
+        for (size_t i = 0;; i ^= 1) {
+            auto &chunk = chunks[i];
+            {
+                std::unique_lock lock{mutex};
+                changed.wait(lock, [&] { return stop or !chunk.full; });
+                if (stop) {
+                    return;
+                }
+            }
+            const auto size = [&] {
+                ScopedTimer timer{"ReadAhead::fill"};
+                return fill(chunk);
+            }();
+            {
+                const std::lock_guard lock{mutex};
+                chunk.size = size;
+                chunk.full = true;
+            }
+            changed.notify_all();
+            if (size == 0) {
+                return;
+            }
+        }
+    }
+
+  public:
+    ReadAhead(const int descriptor) : fd(descriptor), reader([this] { run(); }) {}
+
+    ReadAhead(const ReadAhead &) = delete;
+    ReadAhead &operator=(const ReadAhead &) = delete;
+
+    ~ReadAhead() {
+        {
+            const std::lock_guard lock{mutex};
+            stop = true;
+        }
+        changed.notify_all();
+        reader.join();
+    }
+
+    // Hand the current chunk back to the reader and return the next one.
+    // The view is valid until the next call, empty means EOF.
+    std::string_view next() {
+        if (finished) {
+            return {};
+        }
+        std::unique_lock lock{mutex};
+        if (holding) {
+            chunks[current].full = false;
+            changed.notify_all();
+        }
+        current ^= 1;
+        changed.wait(lock, [&] { return chunks[current].full; });
+        holding = true;
+        if (error != 0) {
+            throw std::system_error(error, std::generic_category(), "ReadAhead");
+        }
+        const auto &chunk = chunks[current];
+        finished = chunk.size == 0;
+        return {chunk.data.data(), chunk.size};
+    }
+
+    // same as std::getline(), the line is copied since it may span chunks
+    bool getline(std::string &line) {
+        line.clear();
+        bool extracted = false;
+        while (true) {
+            if (rest.empty()) {
+                rest = next();
+                if (rest.empty()) {
+                    return extracted;
+                }
+            }
+            extracted = true;
+            const auto newline = rest.find('\n');
+            if (newline != std::string_view::npos) {
+                line.append(rest.substr(0, newline));
+                rest.remove_prefix(newline + 1);
+                return true;
+            }
+            line.append(rest);
+            rest = {};
+        }
+    }
+
+    // read everything up to EOF
+    std::string readAll() {
+        std::string content{rest};
+        rest = {};
+        for (auto chunk = next(); !chunk.empty(); chunk = next()) {
+            content.append(chunk);
+        }
+        return content;
+    }
+};
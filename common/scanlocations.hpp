@@ -1,10 +1,28 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
 
+#include "grid2d.hpp"
 #include "vec2.hpp"
 #include "vec3.hpp"
 
+// ScanLocations: positions from position in steps of direction while they
+// are inside [minCorner, maxCorner].
+// for (const auto look : ScanLocations(pos, dir, {0, 0}, limit)) ...
+//
+// GridRay: the same walk over the cells of a Grid2D as a pointer with a
+// stride, the number of steps is computed once.
+// GridRay(field, from, dir).find([&](char tree) { return tree >= height; })
+//
+// castLine: rays in one direction from every cell of a row or column at
+// once, for "how far until a cell at least as high" questions.
+
 template <typename VEC> class ScanLocations {
     const VEC position{};
     const VEC direction{};
@@ -55,3 +73,83 @@ template <typename VEC> class ScanLocations {
     iterator begin() const { return {*this}; }
     sentinel end() const { return {}; }
 };
+
+template <typename T> class GridRay {
+    // from, the walk steps before reading a cell
+    const T *start{nullptr};
+    int64_t stride{0};
+    int64_t steps{0};
+
+    // steps from pos before leaving [0, size) with dir -1, 0 or 1
+    static int64_t stepsLeft(const int64_t pos, const int64_t dir, const int64_t size) {
+        const auto left = dir > 0 ? size - 1 - pos : pos;
+        return dir != 0 ? left : std::numeric_limits<int64_t>::max();
+    }
+
+  public:
+    // The cells after from in direction up to the edge, from itself is not
+    // part of the ray. from must be inside the grid, the coordinates of
+    // direction are -1, 0 or 1 and not both 0.
+    GridRay(const Grid2D<T> &grid, const Vec2l &from, const Vec2l &direction)
+        : start(&grid[from]), stride(direction.y * grid.stride() + direction.x),
+          steps(std::min(stepsLeft(from.x, direction.x, grid.width()),
+                         stepsLeft(from.y, direction.y, grid.height()))) {}
+
+    // number of cells on the ray
+    int64_t size() const { return steps; }
+
+    // index of the first cell for which stop(cell) is true, or size()
+    template <typename Predicate> int64_t find(Predicate stop) const {
+        const T *cell = start;
+        for (auto left = steps; left > 0; --left) {
+            cell += stride;
+            if (stop(*cell)) {
+                return steps - left;
+            }
+        }
+        return steps;
+    }
+};
+
+// where a ray of castLine() ended
+struct RayStop {
+    // cells passed, including the one the ray stopped at
+    int64_t steps;
+    // false if the ray reached the edge of the grid
+    bool blocked;
+};
+
+// Rays in direction from every cell of one line of the grid: row line for
+// direction {1, 0} / {-1, 0}, column line for {0, 1} / {0, -1}. A ray stops
+// at the first cell that is not less than its start cell. result[i] is the
+// ray of cell i of the line, i is x for rows and y for columns.
+// The line is walked once from the edge the rays point to, with a stack of
+// the cells no later cell has covered yet, instead of one walk per ray.
+template <typename T, typename Less = std::less<T>>
+std::vector<RayStop> castLine(const Grid2D<T> &grid, const int64_t line, const Vec2l &direction,
+                              Less less = {}) {
+    const bool alongX = direction.x != 0;
+    const auto count = alongX ? grid.width() : grid.height();
+    const T *base = alongX ? grid.row(line) : &grid[Vec2l{line, 0}];
+    const auto stride = alongX ? int64_t{1} : grid.stride();
+    const auto step = alongX ? direction.x : direction.y;
+
+    std::vector<RayStop> stops(static_cast<size_t>(count));
+    // cells no later cell has covered yet, the last one is the nearest
+    std::vector<std::pair<T, int64_t>> open(static_cast<size_t>(count));
+    size_t openCount = 0;
+    const T *cell = base + (step > 0 ? (count - 1) * stride : 0);
+    const auto walk = step > 0 ? -stride : stride;
+    for (int64_t n = 0; n < count; ++n, cell += walk) {
+        // n cells lie between i and the edge in direction
+        const auto i = step > 0 ? count - 1 - n : n;
+        while (openCount > 0 and less(open[openCount - 1].first, *cell)) {
+            --openCount;
+        }
+        stops[static_cast<size_t>(i)] =
+            openCount == 0 ? RayStop{n, false}
+                           : RayStop{(open[openCount - 1].second - i) * step, true};
+        open[openCount++] = {*cell, i};
+    }
+    return stops;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <ranges>
+#include <vector>
+
+#include "vec2.hpp"
+#include "vecarray.hpp"
+
+// Sensors with the beacon closest to each of them, like day 15, as a
+// structure of arrays, so the distance checks for a whole row run as
+// vector loops.
+// usage:
+// Sensors sensors{};
+// sensors.add(sensor, closestBeacon);
+// sensors.measure();                   - after the last add()
+// sensors.scanRow(row, [&](const int64_t from, const int64_t to) { ... });
+//                                      - the x range each sensor covers
+
+struct Sensors {
+    Vec2Array<int64_t> position{};
+    Vec2Array<int64_t> beacon{};
+    std::vector<int64_t> beaconDist{};
+    // scratch space for scanRow()
+    std::vector<int64_t> rowDist{};
+
+    void add(const Vec2l &sensor, const Vec2l &closest) {
+        position.push_back(sensor);
+        beacon.push_back(closest);
+    }
+    // call after adding all sensors
+    void measure() { position.manhattan(beacon, beaconDist); }
+
+    // call scan(from, to) for every sensor reaching row
+    void scanRow(const int64_t row, auto scan) {
+        VecSimd::absDiff(position.y, row, rowDist);
+        for (const auto i : std::views::iota(0u, position.size())) {
+            if (rowDist[i] <= beaconDist[i]) {
+                const auto reach = beaconDist[i] - rowDist[i];
+                scan(position.x[i] - reach, position.x[i] + reach);
+            }
+        }
+    }
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mappedfile.hpp"
+#include "simpleparser.hpp"
+
+// Opt-in cache for purely numeric inputs.
+// usage:
+// const NumericColumns<3> cubes{argv[1], [](SimpleParser &scanner, auto &columns) {
+//     ... columns[0].push_back(scanner.getInt64()); ...
+// }};
+// cubes[0] - the first column as std::span<const int64_t>
+//
+// With the environment variable AOC_SIDECAR set, the parsed columns are
+// written to "<input>.bin" and later runs map that file instead of parsing
+// the text again. The sidecar stores a hash of the text, it is rebuilt when
+// the input changes.
+//
+// Sidecar layout, all fields native 64 bit words:
+//   magic, source hash, source size, column count, column sizes..., columns...
+
+namespace Sidecar {
+constexpr uint64_t magic = 0x3145444953434f41; // "AOCSIDE1"
+
+inline bool enabled() { return std::getenv("AOC_SIDECAR") != nullptr; }
+
+inline uint64_t hash(std::string_view text) {
+    constexpr uint64_t mul = 0x9e3779b97f4a7c15;
+    uint64_t h = text.size() * mul;
+    size_t pos = 0;
+    for (; pos + 8 <= text.size(); pos += 8) {
+        uint64_t word;
+        std::memcpy(&word, text.data() + pos, 8);
+        h = (h ^ word) * mul;
+        h ^= h >> 29;
+    }
+    if (pos < text.size()) {
+        uint64_t tail = 0;
+        std::memcpy(&tail, text.data() + pos, text.size() - pos);
+        h = (h ^ tail) * mul;
+    }
+    return h ^ (h >> 32);
+}
+} // namespace Sidecar
+
+template <size_t N> class NumericColumns {
+    using Columns = std::array<std::vector<int64_t>, N>;
+
+    MappedFile sidecar{};
+    Columns parsed{};
+    std::array<std::span<const int64_t>, N> columns{};
+
+    // map the sidecar and check it against the text, returns true on success
+    bool load(const std::string &binName, const uint64_t sourceHash, const size_t sourceSize) {
+        sidecar = MappedFile{binName.c_str()};
+        if (!sidecar.isMapped()) {
+            return false;
+        }
+        const auto raw = sidecar.view();
+        constexpr size_t headerWords = 4 + N;
+        if (raw.size() < headerWords * 8) {
+            return false;
+        }
+        const auto *words = reinterpret_cast<const int64_t *>(raw.data());
+        const auto *header = reinterpret_cast<const uint64_t *>(raw.data());
+        if (header[0] != Sidecar::magic or header[1] != sourceHash or
+            header[2] != sourceSize or header[3] != N) {
+            return false;
+        }
+        size_t offset = headerWords;
+        for (size_t i = 0; i < N; ++i) {
+            const auto size = header[4 + i];
+            if (size > raw.size() / 8 - offset) {
+                return false;
+            }
+            columns[i] = {words + offset, size};
+            offset += size;
+        }
+        return true;
+    }
+
+    void store(const std::string &binName, const uint64_t sourceHash,
+               const size_t sourceSize) const {
+        // write a temporary first, so no reader sees a half written sidecar
+        const auto tmpName = binName + ".tmp";
+        std::ofstream out{tmpName, std::ios::binary};
+        std::vector<uint64_t> header{Sidecar::magic, sourceHash, sourceSize, N};
+        for (const auto &column : parsed) {
+            header.push_back(column.size());
+        }
+        out.write(reinterpret_cast<const char *>(header.data()),
+                  static_cast<std::streamsize>(header.size() * 8));
+        for (const auto &column : parsed) {
+            out.write(reinterpret_cast<const char *>(column.data()),
+                      static_cast<std::streamsize>(column.size() * 8));
+        }
+        out.close();
+        if (out) {
+            std::filesystem::rename(tmpName, binName);
+        } else {
+            std::filesystem::remove(tmpName);
+        }
+    }
+
+    void useParsed() {
+        for (size_t i = 0; i < N; ++i) {
+            columns[i] = parsed[i];
+        }
+    }
+
+  public:
+    // parse(SimpleParser &, std::array<std::vector<int64_t>, N> &) reads the text
+    NumericColumns(const char *filename, auto parse) {
+        if (!Sidecar::enabled()) {
+            SimpleParser scanner{filename};
+            parse(scanner, parsed);
+            useParsed();
+            return;
+        }
+        const MappedFile source{filename};
+        const auto text = source.view();
+        const auto sourceHash = Sidecar::hash(text);
+        const auto binName = std::string{filename} + ".bin";
+        if (source.isMapped() and load(binName, sourceHash, text.size())) {
+            return;
+        }
+        sidecar = MappedFile{};
+        if (source.isMapped()) {
+            SimpleParser scanner{text};
+            parse(scanner, parsed);
+            store(binName, sourceHash, text.size());
+        } else {
+            SimpleParser scanner{filename};
+            parse(scanner, parsed);
+        }
+        useParsed();
+    }
+
+    NumericColumns(const NumericColumns &) = delete;
+    NumericColumns &operator=(const NumericColumns &) = delete;
+
+    std::span<const int64_t> operator[](const size_t i) const { return columns[i]; }
+};
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// Vectorized scanning of a line for SimpleParser.
+// usage:
+// SimdScan::skipSpace(data, pos, size)
+//   - returns the first position >= pos that is not whitespace, or size
+// SimdScan::tokenEnd(data, pos, size, terminate)
+//   - returns the first position >= pos that is whitespace or terminate
+//
+// The kernel is chosen at startup from the CPU features (AVX2, else SSE2 which
+// every x86-64 has), other architectures use the scalar loop.
+// SimdScan::select() overrides the choice, i.e. for benchmarking.
+// Whitespace is the "C" locale set of std::isspace().
+
+namespace SimdScan {
+
+constexpr bool isSpace(const char c) {
+    return c == ' ' or static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+}
+
+inline size_t skipSpaceScalar(const char *data, size_t pos, const size_t size) {
+    while (pos < size and isSpace(data[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+inline size_t tokenEndScalar(const char *data, size_t pos, const size_t size,
+                             const char terminate) {
+    while (pos < size and !isSpace(data[pos]) and data[pos] != terminate) {
+        ++pos;
+    }
+    return pos;
+}
+
+#if defined(__x86_64__)
+// all bytes which are ' ' or in ['\t', '\r'] are set to 0xff
+inline __m128i spaceMask(const __m128i chunk) {
+    const __m128i offset = _mm_sub_epi8(chunk, _mm_set1_epi8('\t'));
+    const __m128i control = _mm_cmpeq_epi8(
+        _mm_subs_epu8(offset, _mm_set1_epi8('\r' - '\t')), _mm_setzero_si128());
+    return _mm_or_si128(control, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')));
+}
+
+inline size_t skipSpaceSse2(const char *data, size_t pos, const size_t size) {
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+        const auto other = ~static_cast<uint32_t>(_mm_movemask_epi8(spaceMask(chunk))) & 0xffff;
+        if (other != 0) {
+            return pos + static_cast<size_t>(__builtin_ctz(other));
+        }
+    }
+    return skipSpaceScalar(data, pos, size);
+}
+
+inline size_t tokenEndSse2(const char *data, size_t pos, const size_t size,
+                           const char terminate) {
+    const __m128i term = _mm_set1_epi8(terminate);
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+        const __m128i stop = _mm_or_si128(spaceMask(chunk), _mm_cmpeq_epi8(chunk, term));
+        const auto found = static_cast<uint32_t>(_mm_movemask_epi8(stop));
+        if (found != 0) {
+            return pos + static_cast<size_t>(__builtin_ctz(found));
+        }
+    }
+    return tokenEndScalar(data, pos, size, terminate);
+}
+
+__attribute__((target("avx2"))) inline __m256i spaceMask(const __m256i chunk) {
+    const __m256i offset = _mm256_sub_epi8(chunk, _mm256_set1_epi8('\t'));
+    const __m256i control = _mm256_cmpeq_epi8(
+        _mm256_subs_epu8(offset, _mm256_set1_epi8('\r' - '\t')), _mm256_setzero_si256());
+    return _mm256_or_si256(control, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')));
+}
+
+__attribute__((target("avx2"))) inline size_t skipSpaceAvx2(const char *data, size_t pos,
+                                                            const size_t size) {
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i chunk =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+        const auto other = ~static_cast<uint32_t>(_mm256_movemask_epi8(spaceMask(chunk)));
+        if (other != 0) {
+            return pos + static_cast<size_t>(__builtin_ctz(other));
+        }
+    }
+    return skipSpaceSse2(data, pos, size);
+}
+
+__attribute__((target("avx2"))) inline size_t tokenEndAvx2(const char *data, size_t pos,
+                                                           const size_t size,
+                                                           const char terminate) {
+    const __m256i term = _mm256_set1_epi8(terminate);
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i chunk =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+        const __m256i stop = _mm256_or_si256(spaceMask(chunk), _mm256_cmpeq_epi8(chunk, term));
+        const auto found = static_cast<uint32_t>(_mm256_movemask_epi8(stop));
+        if (found != 0) {
+            return pos + static_cast<size_t>(__builtin_ctz(found));
+        }
+    }
+    return tokenEndSse2(data, pos, size, terminate);
+}
+#endif
+
+enum class Level { scalar, sse2, avx2 };
+
+struct Kernels {
+    Level level;
+    const char *name;
+    size_t (*skipSpace)(const char *, size_t, size_t);
+    size_t (*tokenEnd)(const char *, size_t, size_t, char);
+};
+
+inline Kernels kernelsFor(const Level level) {
+#if defined(__x86_64__)
+    switch (level) {
+    case Level::avx2:
+        return {level, "avx2", skipSpaceAvx2, tokenEndAvx2};
+    case Level::sse2:
+        return {level, "sse2", skipSpaceSse2, tokenEndSse2};
+    case Level::scalar:
+        break;
+    }
+#endif
+    return {Level::scalar, "scalar", skipSpaceScalar, tokenEndScalar};
+}
+
+inline Level bestLevel() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Level::avx2;
+    }
+    return Level::sse2;
+#else
+    return Level::scalar;
+#endif
+}
+
+inline Kernels active = kernelsFor(bestLevel());
+
+// returns the name of the kernel actually used
+inline const char *select(const Level level) {
+    active = kernelsFor(std::min(level, bestLevel()));
+    return active.name;
+}
+
+// Most whitespace runs and tokens are short, scan a few bytes inline before
+// paying for the indirect call
+constexpr size_t inlineScan = 8;
+
+inline size_t skipSpace(const char *data, size_t pos, const size_t size) {
+    const auto inlineEnd = std::min(size, pos + inlineScan);
+    for (; pos < inlineEnd; ++pos) {
+        if (!isSpace(data[pos])) {
+            return pos;
+        }
+    }
+    if (size - pos < 16) {
+        return skipSpaceScalar(data, pos, size);
+    }
+    return active.skipSpace(data, pos, size);
+}
+
+inline size_t tokenEnd(const char *data, size_t pos, const size_t size, const char terminate) {
+    const auto inlineEnd = std::min(size, pos + inlineScan);
+    for (; pos < inlineEnd; ++pos) {
+        if (isSpace(data[pos]) or data[pos] == terminate) {
+            return pos;
+        }
+    }
+    if (size - pos < 16) {
+        return tokenEndScalar(data, pos, size, terminate);
+    }
+    return active.tokenEnd(data, pos, size, terminate);
+}
+
+} // namespace SimdScan
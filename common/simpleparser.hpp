@@ -1,21 +1,187 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cctype>
+#include <charconv>
+#include <cstring>
 #include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "mappedfile.hpp"
+#include "readahead.hpp"
+#include "simdscan.hpp"
+
+// string literal usable as template argument, e.g. scan<"x={}, y={}">()
+template <size_t N> struct FixedString {
+    char data[N]{};
+
+    constexpr FixedString(const char (&str)[N]) { std::copy_n(str, N, data); }
+    constexpr std::string_view view() const { return {data, N - 1}; }
+};
+
+namespace ScanPattern {
+// Pattern fields: "{}" reads an int64_t, "{s}" a token as std::string_view.
+// The literal text in between is matched like skipToken(), so whitespace
+// around the literals is ignored.
+enum class Field { int64, token };
+
+constexpr bool isSpace(const char c) {
+    return c == ' ' or c == '\t' or c == '\n' or c == '\r' or c == '\f' or c == '\v';
+}
+
+constexpr std::string_view trim(std::string_view text) {
+    while (!text.empty() and isSpace(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() and isSpace(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+template <FixedString Pattern> struct Compiled {
+    static constexpr std::string_view text = Pattern.view();
+
+    static constexpr size_t fieldCount = [] {
+        size_t count = 0;
+        for (size_t start = text.find('{'); start != text.npos; start = text.find('{', start)) {
+            const auto close = text.find('}', start);
+            if (close == text.npos) {
+                throw "unterminated field in scan pattern";
+            }
+            ++count;
+            start = close;
+        }
+        return count;
+    }();
+
+    // literals[i] precedes field i, the last one follows the last field
+    static constexpr auto literals = [] {
+        std::array<std::string_view, fieldCount + 1> result{};
+        size_t from = 0;
+        for (size_t i = 0; i < fieldCount; ++i) {
+            const auto start = text.find('{', from);
+            result[i] = trim(text.substr(from, start - from));
+            from = text.find('}', start) + 1;
+        }
+        result[fieldCount] = trim(text.substr(from));
+        return result;
+    }();
+
+    static constexpr auto fields = [] {
+        std::array<Field, fieldCount> result{};
+        size_t from = 0;
+        for (size_t i = 0; i < fieldCount; ++i) {
+            const auto start = text.find('{', from);
+            const auto close = text.find('}', start);
+            const auto spec = text.substr(start + 1, close - start - 1);
+            if (spec == "") {
+                result[i] = Field::int64;
+            } else if (spec == "s") {
+                result[i] = Field::token;
+            } else {
+                throw "unknown field in scan pattern";
+            }
+            from = close + 1;
+        }
+        return result;
+    }();
+
+    // a token field stops at the first character of the next literal if
+    // that directly follows the field, i.e. the ':' of "{s}:{}", otherwise
+    // at whitespace only
+    static constexpr auto terminators = [] {
+        std::array<char, fieldCount> result{};
+        size_t from = 0;
+        for (size_t i = 0; i < fieldCount; ++i) {
+            const auto close = text.find('}', text.find('{', from));
+            if (close + 1 < text.size() and !isSpace(text[close + 1]) and
+                text[close + 1] != '{') {
+                result[i] = text[close + 1];
+            }
+            from = close + 1;
+        }
+        return result;
+    }();
+
+    template <size_t I>
+    using FieldType =
+        std::conditional_t<fields[I] == Field::int64, int64_t, std::string_view>;
+
+    using Tuple = decltype([]<size_t... I>(std::index_sequence<I...>) {
+        return std::tuple<FieldType<I>...>{};
+    }(std::make_index_sequence<fieldCount>{}));
+};
+} // namespace ScanPattern
 
 class SimpleParser {
     std::ifstream localStream{};
     std::ifstream &in;
 
+    // memory backed input: a mapped file or memory owned by the caller
+    MappedFile mappedFile{};
+    std::string_view memory{};
+    bool memoryBacked{false};
+    size_t memoryPos{0}; // start of the next line
+
+    // stdin, read in a background thread
+    std::unique_ptr<ReadAhead> readAhead{};
+
+    // storage for the last lines when reading from a stream. Lines rotate
+    // through the buffers, so a view into a line survives reading the next
+    // one, and the read after that, which may be the end of the input.
+    // Empty lines are read into the next buffer without taking a turn, a
+    // run of them can't wrap around onto the line before.
+    std::array<std::string, 3> lineBuffer{};
+    size_t currentLine{0};
+
     // buffer will always contain at least 1 char, or eof==true
-    std::string buffer;
+    // it points either into lineBuffer or into memory
+    std::string_view buffer;
     size_t pos;
     bool eof;
 
+    bool nextLine() {
+        if (!memoryBacked) {
+            const auto next = (currentLine + 1) % lineBuffer.size();
+            auto &line = lineBuffer[next];
+            const bool read = readAhead ? readAhead->getline(line)
+                                        : static_cast<bool>(std::getline(in, line));
+            if (!read) {
+                buffer = {};
+                return false;
+            }
+            if (!line.empty()) {
+                currentLine = next;
+            }
+            buffer = line;
+            return true;
+        }
+        if (memoryPos >= memory.size()) {
+            buffer = {};
+            return false;
+        }
+        const char *start = memory.data() + memoryPos;
+        const auto *newline = static_cast<const char *>(
+            std::memchr(start, '\n', memory.size() - memoryPos));
+        const size_t length = newline != nullptr ? static_cast<size_t>(newline - start)
+                                                 : memory.size() - memoryPos;
+        buffer = {start, length};
+        memoryPos += length + 1;
+        return true;
+    }
+
     void bufferSaturate() {
         while (!eof && pos >= buffer.size()) {
-            eof = !std::getline(in, buffer);
+            eof = !nextLine();
             pos = 0;
         }
     }
@@ -40,60 +206,222 @@ class SimpleParser {
         return c;
     }
 
+    // parse a number at pos without leaving the current line
+    int64_t bufferInt64() {
+        const char *first = buffer.data() + pos;
+        const char *last = buffer.data() + buffer.size();
+        // std::from_chars does not accept a leading plus, std::stoll does
+        if (last - first > 1 && first[0] == '+' && std::isdigit(first[1])) {
+            ++first;
+        }
+        int64_t value{};
+        const auto [end, error] = std::from_chars(first, last, value);
+        if (error == std::errc::invalid_argument) {
+            throw std::invalid_argument("SimpleParser::getInt64");
+        } else if (error == std::errc::result_out_of_range) {
+            throw std::out_of_range("SimpleParser::getInt64");
+        }
+        pos = static_cast<size_t>(end - buffer.data());
+        return value;
+    }
+
+    // match a literal of a scan pattern, the size is known at compile time
+    template <std::string_view const &literal> bool scanLiteral() {
+        if constexpr (!literal.empty()) {
+            skipWhitespace();
+            if (buffer.size() - pos < literal.size() or
+                std::memcmp(buffer.data() + pos, literal.data(), literal.size()) != 0) {
+                return false;
+            }
+            pos += literal.size();
+            bufferSaturate();
+        }
+        return true;
+    }
+
+    template <ScanPattern::Field field, char terminate>
+    bool scanField(auto &value) {
+        skipWhitespace();
+        if (eof) {
+            return false;
+        }
+        if constexpr (field == ScanPattern::Field::int64) {
+            const char *first = buffer.data() + pos;
+            const char *last = buffer.data() + buffer.size();
+            if (last - first > 1 and first[0] == '+' and std::isdigit(first[1])) {
+                ++first;
+            }
+            const auto [end, error] = std::from_chars(first, last, value);
+            if (error != std::errc{}) {
+                return false;
+            }
+            pos = static_cast<size_t>(end - buffer.data());
+        } else {
+            const auto end = SimdScan::tokenEnd(buffer.data(), pos, buffer.size(), terminate);
+            value = buffer.substr(pos, end - pos);
+            pos = end;
+        }
+        bufferSaturate();
+        return true;
+    }
+
+    template <typename Compiled, size_t I> bool scanStep(typename Compiled::Tuple &result) {
+        return scanLiteral<Compiled::literals[I]>() and
+               scanField<Compiled::fields[I], Compiled::terminators[I]>(std::get<I>(result));
+    }
+
   public:
+    // tag to select the memory mapped backend
+    struct MemoryMapped {};
+    static constexpr MemoryMapped memoryMapped{};
+
     SimpleParser(std::ifstream &);
+    // "-" reads stdin, i.e. "gen | ./sand -"
     SimpleParser(const char *);
+    // map the whole file and parse from the mapped bytes without copying
+    // them into a line buffer. Falls back to reading a stream if the file
+    // can't be mapped (e.g. a pipe).
+    SimpleParser(const char *, MemoryMapped);
+    // parse memory owned by the caller, it has to outlive the parser
+    SimpleParser(std::string_view);
+    SimpleParser(const SimpleParser &) = delete;
+    SimpleParser &operator=(const SimpleParser &) = delete;
 
     bool isEof() const;
 
     int64_t getInt64();
+    size_t getInt64s(std::vector<int64_t> &, std::string_view separators = ",");
     std::string getToken(const char terminate = '\0');
     std::string getAlNum();
+    // Same as getToken() and getAlNum(), but without copying the token.
+    // With stream input the view is valid until the parser moves past the
+    // line after it, with memory backed input as long as the memory.
+    std::string_view getTokenView(const char terminate = '\0');
+    std::string_view getAlNumView();
 
     char peekChar();
 
     void skipWhitespace();
     bool skipChar(const char);
-    bool skipToken(const std::string &);
+    bool skipToken(std::string_view);
+
+    // Read a whole record described by a pattern, i.e.
+    //   const auto [x, y] = *scanner.scan<"x={}, y={}">();
+    // see ScanPattern for the syntax. If the input does not match, the rest
+    // of the line the mismatch is on is skipped and std::nullopt returned.
+    // That is the line of the record, unless its fields already went on to
+    // the next lines. Token fields are views with the same lifetime as
+    // getTokenView().
+    template <FixedString Pattern> auto scan() -> std::optional<typename ScanPattern::Compiled<Pattern>::Tuple>;
 };
 
+template <FixedString Pattern>
+auto SimpleParser::scan() -> std::optional<typename ScanPattern::Compiled<Pattern>::Tuple> {
+    using Compiled = ScanPattern::Compiled<Pattern>;
+    typename Compiled::Tuple result{};
+    const bool matched = [&]<size_t... I>(std::index_sequence<I...>) {
+        return (scanStep<Compiled, I>(result) and ...) and
+               scanLiteral<Compiled::literals[Compiled::fieldCount]>();
+    }(std::make_index_sequence<Compiled::fieldCount>{});
+    if (!matched) {
+        // the line parsing stopped on, earlier lines are gone with a stream
+        pos = buffer.size();
+        bufferSaturate();
+        return std::nullopt;
+    }
+    return result;
+}
+
 SimpleParser::SimpleParser(std::ifstream &stream) : in(stream), buffer(""), pos(0), eof(false) {
     bufferSaturate();
 }
 
-SimpleParser::SimpleParser(const char *infile)
-    : localStream(std::ifstream(infile)), in(localStream), buffer(""), pos(0), eof(false) {
+SimpleParser::SimpleParser(const char *infile) : in(localStream), buffer(""), pos(0), eof(false) {
+    if (std::string_view{infile} == "-") {
+        readAhead = std::make_unique<ReadAhead>(STDIN_FILENO);
+    } else {
+        localStream.open(infile);
+    }
+    bufferSaturate();
+}
+
+SimpleParser::SimpleParser(const char *infile, MemoryMapped)
+    : in(localStream), mappedFile(infile), buffer(""), pos(0), eof(false) {
+    if (mappedFile.isMapped()) {
+        memory = mappedFile.view();
+        memoryBacked = true;
+    } else if (std::string_view{infile} == "-") {
+        readAhead = std::make_unique<ReadAhead>(STDIN_FILENO);
+    } else {
+        localStream.open(infile);
+    }
+    bufferSaturate();
+}
+
+SimpleParser::SimpleParser(std::string_view input)
+    : in(localStream), memory(input), memoryBacked(true), buffer(""), pos(0), eof(false) {
     bufferSaturate();
 }
 
 int64_t SimpleParser::getInt64() {
     skipWhitespace();
-    size_t processed;
-    const int64_t value = std::stoll(buffer.substr(pos), &processed);
-    pos += processed;
+    const int64_t value = bufferInt64();
     bufferSaturate();
     return value;
 }
 
-std::string SimpleParser::getToken(const char terminate) {
+// Append a run of numbers on the current line to out, i.e. "1, 2, 3" or
+// "4,5 -> 6,7". Numbers are separated by any mix of whitespace and the
+// characters in separators, so a number can't carry a sign that is also a
+// separator ("1 -> -2").
+// Returns the count of numbers read.
+size_t SimpleParser::getInt64s(std::vector<int64_t> &out, std::string_view separators) {
     skipWhitespace();
-    auto end = pos;
-    while (end < buffer.size() && !std::isspace(buffer[end]) && buffer[end] != terminate) {
-        ++end;
+    size_t count = 0;
+    while (!eof) {
+        out.push_back(bufferInt64());
+        ++count;
+        auto next = pos;
+        bool separated = false;
+        while (next < buffer.size() &&
+               (SimdScan::isSpace(buffer[next]) || separators.find(buffer[next]) != separators.npos)) {
+            separated |= separators.find(buffer[next]) != separators.npos;
+            ++next;
+        }
+        if (!separated) {
+            break;
+        }
+        pos = next;
+        if (pos >= buffer.size()) {
+            break;
+        }
     }
-    auto token = buffer.substr(pos, end - pos);
+    bufferSaturate();
+    return count;
+}
+
+std::string SimpleParser::getToken(const char terminate) {
+    return std::string{getTokenView(terminate)};
+}
+
+std::string SimpleParser::getAlNum() { return std::string{getAlNumView()}; }
+
+std::string_view SimpleParser::getTokenView(const char terminate) {
+    skipWhitespace();
+    const auto end = SimdScan::tokenEnd(buffer.data(), pos, buffer.size(), terminate);
+    const auto token = buffer.substr(pos, end - pos);
     pos = end;
     bufferSaturate();
     return token;
 }
 
-std::string SimpleParser::getAlNum() {
+std::string_view SimpleParser::getAlNumView() {
     skipWhitespace();
     auto end = pos;
     while (end < buffer.size() && std::isalnum(buffer[end])) {
         ++end;
     }
-    auto token = buffer.substr(pos, end - pos);
+    const auto token = buffer.substr(pos, end - pos);
     pos = end;
     bufferSaturate();
     return token;
@@ -110,8 +438,12 @@ char SimpleParser::peekChar() {
 }
 
 void SimpleParser::skipWhitespace() {
-    while (!eof && std::isspace(buffer[pos])) {
-        bufferNextChar();
+    while (!eof) {
+        pos = SimdScan::skipSpace(buffer.data(), pos, buffer.size());
+        if (pos < buffer.size()) {
+            return;
+        }
+        bufferSaturate();
     }
 }
 
@@ -125,9 +457,9 @@ bool SimpleParser::skipChar(const char c) {
 }
 
 // If token follows in the input, skip over it and return true
-bool SimpleParser::skipToken(const std::string &token) {
+bool SimpleParser::skipToken(std::string_view token) {
     skipWhitespace();
-    if (buffer.find(token.data(), pos, token.size()) == pos) {
+    if (buffer.substr(pos).starts_with(token)) {
         pos += token.size();
         bufferSaturate();
         return true;
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Assigns every distinct name a dense id 0, 1, 2, ... in order of appearance,
+// so names can index plain vectors instead of maps keyed by strings.
+// usage:
+// const auto id = symbols.intern(scanner.getTokenView());
+// symbols.name(id) - the name as std::string_view
+class SymbolTable {
+    struct Hash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+
+    std::unordered_map<std::string, uint32_t, Hash, std::equal_to<>> ids{};
+    // views into the keys of ids, which never move
+    std::vector<std::string_view> names{};
+
+  public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    // id of name, a new id if name was not seen before
+    uint32_t intern(std::string_view name) {
+        const auto found = ids.find(name);
+        if (found != ids.end()) {
+            return found->second;
+        }
+        const auto id = static_cast<uint32_t>(names.size());
+        const auto [inserted, _] = ids.emplace(name, id);
+        names.push_back(inserted->first);
+        return id;
+    }
+
+    // id of name, or npos if it was never interned
+    uint32_t find(std::string_view name) const {
+        const auto found = ids.find(name);
+        return found != ids.end() ? found->second : npos;
+    }
+
+    std::string_view name(const uint32_t id) const { return names[id]; }
+
+    size_t size() const { return names.size(); }
+};
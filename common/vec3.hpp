@@ -85,7 +85,7 @@ template <typename iter>
 concept isVec3Iterable = is_instantiation_of<Vec3, typename iter::value_type>::value;
 
 template <typename iterable>
-constexpr auto boundingBox(iterable &container) requires isVec3Iterable<iterable> {
+constexpr auto boundingBox(const iterable &container) requires isVec3Iterable<iterable> {
     auto it = container.begin();
     auto min{*it};
     auto max{*it};
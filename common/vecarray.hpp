@@ -0,0 +1,343 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "simdscan.hpp"
+#include "vec2.hpp"
+#include "vec3.hpp"
+
+// Structure of arrays for Vec2 / Vec3: one std::vector per coordinate.
+// usage:
+// Vec2Array<int64_t> elves{};
+// elves.push_back({x, y});
+// elves += Vec2l{1, 0};                - move all of them
+// elves.manhattan(point, distances);   - distance of every elf to point
+// boundingBox(elves)                   - std::pair<min, max>, also for
+//                                        std::vector<Vec2> / std::span
+//
+// The loops over whole arrays are vectorized. They are compiled twice, for
+// the baseline and for AVX2, and the CPU picks one at runtime like SimdScan.
+
+namespace VecSimd {
+#if defined(__x86_64__)
+inline const bool useAvx2 = SimdScan::bestLevel() == SimdScan::Level::avx2;
+
+template <typename Kernel, typename... Args>
+__attribute__((target("avx2"))) auto runAvx2(const Kernel &kernel, Args... args) {
+    return kernel(args...);
+}
+#endif
+
+// Run kernel(args...), the kernel has to be always_inline so it gets the
+// instruction set of the caller. It takes __restrict pointers, which lets
+// the compiler vectorize without runtime alias checks.
+template <typename Kernel, typename... Args> auto run(const Kernel &kernel, Args... args) {
+#if defined(__x86_64__)
+    if (useAvx2) {
+        return runAvx2(kernel, args...);
+    }
+#endif
+    return kernel(args...);
+}
+
+template <typename T> void translate(std::vector<T> &lane, const T offset) {
+    run(
+        [](T *__restrict out, const T by, const size_t size) __attribute__((always_inline)) {
+            for (size_t i = 0; i < size; ++i) {
+                out[i] += by;
+            }
+        },
+        lane.data(), offset, lane.size());
+}
+
+template <typename T> void add(std::vector<T> &lane, const std::vector<T> &other) {
+    run(
+        [](T *__restrict out, const T *__restrict in, const size_t size)
+            __attribute__((always_inline)) {
+                for (size_t i = 0; i < size; ++i) {
+                    out[i] += in[i];
+                }
+            },
+        lane.data(), other.data(), lane.size());
+}
+
+template <typename T> void signum(const std::vector<T> &lane, std::vector<T> &result) {
+    result.resize(lane.size());
+    run(
+        [](const T *__restrict in, T *__restrict out, const size_t size)
+            __attribute__((always_inline)) {
+                for (size_t i = 0; i < size; ++i) {
+                    out[i] = static_cast<T>((T{0} < in[i]) - (in[i] < T{0}));
+                }
+            },
+        lane.data(), result.data(), lane.size());
+}
+
+// result = |lane - value|, or result += |lane - value| with accumulate
+template <typename T>
+void absDiff(const std::vector<T> &lane, const T value, std::vector<T> &result,
+             const bool accumulate = false) {
+    result.resize(lane.size());
+    run(
+        [](const T *__restrict in, const T to, T *__restrict out, const size_t size,
+           const bool sum) __attribute__((always_inline)) {
+            if (sum) {
+                for (size_t i = 0; i < size; ++i) {
+                    out[i] += in[i] < to ? to - in[i] : in[i] - to;
+                }
+            } else {
+                for (size_t i = 0; i < size; ++i) {
+                    out[i] = in[i] < to ? to - in[i] : in[i] - to;
+                }
+            }
+        },
+        lane.data(), value, result.data(), lane.size(), accumulate);
+}
+
+// result = |lane - other| element by element, or result += with accumulate
+template <typename T>
+void absDiff(const std::vector<T> &lane, const std::vector<T> &other, std::vector<T> &result,
+             const bool accumulate = false) {
+    result.resize(lane.size());
+    run(
+        [](const T *__restrict in, const T *__restrict to, T *__restrict out, const size_t size,
+           const bool sum) __attribute__((always_inline)) {
+            if (sum) {
+                for (size_t i = 0; i < size; ++i) {
+                    out[i] += in[i] < to[i] ? to[i] - in[i] : in[i] - to[i];
+                }
+            } else {
+                for (size_t i = 0; i < size; ++i) {
+                    out[i] = in[i] < to[i] ? to[i] - in[i] : in[i] - to[i];
+                }
+            }
+        },
+        lane.data(), other.data(), result.data(), lane.size(), accumulate);
+}
+
+// lane must not be empty
+template <typename T> std::pair<T, T> minMax(const std::vector<T> &lane) {
+    return run(
+        [](const T *__restrict in, const size_t size) __attribute__((always_inline)) {
+            T min = in[0];
+            T max = in[0];
+            for (size_t i = 1; i < size; ++i) {
+                min = in[i] < min ? in[i] : min;
+                max = in[i] > max ? in[i] : max;
+            }
+            return std::pair{min, max};
+        },
+        lane.data(), lane.size());
+}
+
+// Min and max of each lane of count elements with lanes values each, i.e.
+// the x and y of a std::vector<Vec2l> for lanes = 2. count must not be 0.
+template <size_t lanes, typename T>
+std::pair<std::array<T, lanes>, std::array<T, lanes>> minMaxInterleaved(const T *data,
+                                                                        const size_t count) {
+    return run(
+        [](const T *__restrict in, const size_t size) __attribute__((always_inline)) {
+            // lanes vectors hold a whole number of elements, so every value
+            // of the vectors stays in the same lane from block to block.
+            // Several blocks at once hide the latency of compare and blend.
+            // typedef, GCC drops the attribute from a dependent using alias
+            typedef T Vector __attribute__((vector_size(32)));
+            constexpr size_t width = sizeof(Vector) / sizeof(T);
+            constexpr size_t vectors = lanes * 2;
+            constexpr size_t block = vectors * width;
+            Vector min[vectors];
+            Vector max[vectors];
+            for (size_t j = 0; j < block; ++j) {
+                min[j / width][j % width] = max[j / width][j % width] = in[j % lanes];
+            }
+            const auto values = size * lanes;
+            size_t i = 0;
+            for (; i + block <= values; i += block) {
+                for (size_t k = 0; k < vectors; ++k) {
+                    Vector next;
+                    std::memcpy(&next, in + i + k * width, sizeof(Vector));
+                    min[k] = next < min[k] ? next : min[k];
+                    max[k] = next > max[k] ? next : max[k];
+                }
+            }
+            std::array<T, lanes> low{};
+            std::array<T, lanes> high{};
+            for (size_t j = 0; j < lanes; ++j) {
+                low[j] = in[j];
+                high[j] = in[j];
+            }
+            for (size_t j = 0; j < block; ++j) {
+                low[j % lanes] = std::min(low[j % lanes], min[j / width][j % width]);
+                high[j % lanes] = std::max(high[j % lanes], max[j / width][j % width]);
+            }
+            // the rest starts at a whole element, so i % lanes is its lane
+            for (; i < values; ++i) {
+                low[i % lanes] = std::min(low[i % lanes], in[i]);
+                high[i % lanes] = std::max(high[i % lanes], in[i]);
+            }
+            return std::pair{low, high};
+        },
+        data, count);
+}
+} // namespace VecSimd
+
+template <typename T> struct Vec2Array {
+    std::vector<T> x{};
+    std::vector<T> y{};
+
+    Vec2Array() = default;
+    Vec2Array(const size_t size, const Vec2<T> &fill = {}) : x(size, fill.x), y(size, fill.y) {}
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+    void clear() {
+        x.clear();
+        y.clear();
+    }
+    void push_back(const Vec2<T> &v) {
+        x.push_back(v.x);
+        y.push_back(v.y);
+    }
+
+    Vec2<T> operator[](const size_t i) const { return {x[i], y[i]}; }
+    void set(const size_t i, const Vec2<T> &v) {
+        x[i] = v.x;
+        y[i] = v.y;
+    }
+
+    Vec2Array &operator+=(const Vec2<T> &offset) {
+        VecSimd::translate(x, offset.x);
+        VecSimd::translate(y, offset.y);
+        return *this;
+    }
+    // both arrays need the same size
+    Vec2Array &operator+=(const Vec2Array &other) {
+        VecSimd::add(x, other.x);
+        VecSimd::add(y, other.y);
+        return *this;
+    }
+
+    // Manhattan distance of every element to point, into distances
+    void manhattan(const Vec2<T> &point, std::vector<T> &distances) const {
+        VecSimd::absDiff(x, point.x, distances);
+        VecSimd::absDiff(y, point.y, distances, true);
+    }
+    // Manhattan distance between the elements of both arrays
+    void manhattan(const Vec2Array &other, std::vector<T> &distances) const {
+        VecSimd::absDiff(x, other.x, distances);
+        VecSimd::absDiff(y, other.y, distances, true);
+    }
+};
+
+template <typename T> Vec2Array<T> signum(const Vec2Array<T> &vec) {
+    Vec2Array<T> result{};
+    VecSimd::signum(vec.x, result.x);
+    VecSimd::signum(vec.y, result.y);
+    return result;
+}
+
+// The array must not be empty.
+template <typename T> std::pair<Vec2<T>, Vec2<T>> boundingBox(const Vec2Array<T> &vec) {
+    const auto [minX, maxX] = VecSimd::minMax(vec.x);
+    const auto [minY, maxY] = VecSimd::minMax(vec.y);
+    return {{minX, minY}, {maxX, maxY}};
+}
+
+// Contiguous Vec2 are read as one array of interleaved x and y.
+// The span must not be empty.
+template <typename T> std::pair<Vec2<T>, Vec2<T>> boundingBox(const std::span<const Vec2<T>> vec) {
+    static_assert(sizeof(Vec2<T>) == 2 * sizeof(T));
+    const auto [min, max] =
+        VecSimd::minMaxInterleaved<2>(reinterpret_cast<const T *>(vec.data()), vec.size());
+    return {{min[0], min[1]}, {max[0], max[1]}};
+}
+
+template <typename T> std::pair<Vec2<T>, Vec2<T>> boundingBox(const std::vector<Vec2<T>> &vec) {
+    return boundingBox(std::span<const Vec2<T>>{vec});
+}
+
+template <typename T> struct Vec3Array {
+    std::vector<T> x{};
+    std::vector<T> y{};
+    std::vector<T> z{};
+
+    Vec3Array() = default;
+    Vec3Array(const size_t size, const Vec3<T> &fill = {})
+        : x(size, fill.x), y(size, fill.y), z(size, fill.z) {}
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+    void clear() {
+        x.clear();
+        y.clear();
+        z.clear();
+    }
+    void push_back(const Vec3<T> &v) {
+        x.push_back(v.x);
+        y.push_back(v.y);
+        z.push_back(v.z);
+    }
+
+    Vec3<T> operator[](const size_t i) const { return {x[i], y[i], z[i]}; }
+    void set(const size_t i, const Vec3<T> &v) {
+        x[i] = v.x;
+        y[i] = v.y;
+        z[i] = v.z;
+    }
+
+    Vec3Array &operator+=(const Vec3<T> &offset) {
+        VecSimd::translate(x, offset.x);
+        VecSimd::translate(y, offset.y);
+        VecSimd::translate(z, offset.z);
+        return *this;
+    }
+    Vec3Array &operator+=(const Vec3Array &other) {
+        VecSimd::add(x, other.x);
+        VecSimd::add(y, other.y);
+        VecSimd::add(z, other.z);
+        return *this;
+    }
+
+    void manhattan(const Vec3<T> &point, std::vector<T> &distances) const {
+        VecSimd::absDiff(x, point.x, distances);
+        VecSimd::absDiff(y, point.y, distances, true);
+        VecSimd::absDiff(z, point.z, distances, true);
+    }
+    void manhattan(const Vec3Array &other, std::vector<T> &distances) const {
+        VecSimd::absDiff(x, other.x, distances);
+        VecSimd::absDiff(y, other.y, distances, true);
+        VecSimd::absDiff(z, other.z, distances, true);
+    }
+};
+
+template <typename T> Vec3Array<T> signum(const Vec3Array<T> &vec) {
+    Vec3Array<T> result{};
+    VecSimd::signum(vec.x, result.x);
+    VecSimd::signum(vec.y, result.y);
+    VecSimd::signum(vec.z, result.z);
+    return result;
+}
+
+template <typename T> std::pair<Vec3<T>, Vec3<T>> boundingBox(const Vec3Array<T> &vec) {
+    const auto [minX, maxX] = VecSimd::minMax(vec.x);
+    const auto [minY, maxY] = VecSimd::minMax(vec.y);
+    const auto [minZ, maxZ] = VecSimd::minMax(vec.z);
+    return {{minX, minY, minZ}, {maxX, maxY, maxZ}};
+}
+
+template <typename T> std::pair<Vec3<T>, Vec3<T>> boundingBox(const std::span<const Vec3<T>> vec) {
+    static_assert(sizeof(Vec3<T>) == 3 * sizeof(T));
+    const auto [min, max] =
+        VecSimd::minMaxInterleaved<3>(reinterpret_cast<const T *>(vec.data()), vec.size());
+    return {{min[0], min[1], min[2]}, {max[0], max[1], max[2]}};
+}
+
+template <typename T> std::pair<Vec3<T>, Vec3<T>> boundingBox(const std::vector<Vec3<T>> &vec) {
+    return boundingBox(std::span<const Vec3<T>>{vec});
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "vec3.hpp"
+
+// One bit per voxel of a box.
+// usage:
+// VoxelGrid lava{min, max};            - box from min to max, both inclusive
+// lava.set(pos);
+// 6 * lava.count() - lava.facesTouching(lava)  - faces not touching lava
+// const auto water = lava.reachable(min);      - flood fill around lava
+//
+// Bit x of a row (y, z) is voxel (x, y, z), rows are padded to whole words.
+// Face counting ANDs a row with its neighbour rows, or with itself shifted
+// by one bit for neighbours along x, and counts the bits of the result.
+class VoxelGrid {
+    Vec3l low;
+    Vec3l high;
+    int64_t width;
+    int64_t height;
+    int64_t depth;
+    size_t rowWords;
+    std::vector<uint64_t> words;
+
+    // first word of row (y, z) relative to the box
+    size_t rowStart(const int64_t y, const int64_t z) const {
+        return static_cast<size_t>(z * height + y) * rowWords;
+    }
+    size_t wordOf(const Vec3l &pos) const {
+        const auto rel = pos - low;
+        return rowStart(rel.y, rel.z) + static_cast<size_t>(rel.x / 64);
+    }
+    static uint64_t bitOf(const Vec3l &pos, const Vec3l &origin) {
+        return uint64_t{1} << ((pos.x - origin.x) % 64);
+    }
+
+    // bits [from, to] of word w of a row, both relative to the row start
+    static uint64_t spanMask(const size_t w, const int64_t from, const int64_t to) {
+        const auto first = static_cast<int64_t>(w) * 64;
+        const auto lowBit = std::max<int64_t>(from - first, 0);
+        const auto highBit = std::min<int64_t>(to - first, 63);
+        if (lowBit > highBit) {
+            return 0;
+        }
+        return (~uint64_t{0} >> (63 - highBit)) & (~uint64_t{0} << lowBit);
+    }
+
+    // pairs of a set voxel in a and a set voxel in the row b one step along x
+    static size_t pairsAlongX(const uint64_t *a, const uint64_t *b, const size_t count) {
+        size_t pairs = 0;
+        for (size_t w = 0; w < count; ++w) {
+            // b at x + 1 and b at x - 1, moved onto x
+            const auto next = b[w] >> 1 | (w + 1 < count ? b[w + 1] << 63 : 0);
+            const auto prev = b[w] << 1 | (w > 0 ? b[w - 1] >> 63 : 0);
+            pairs += static_cast<size_t>(std::popcount(a[w] & next) + std::popcount(a[w] & prev));
+        }
+        return pairs;
+    }
+
+    static size_t pairsInRow(const uint64_t *a, const uint64_t *b, const size_t count) {
+        size_t pairs = 0;
+        for (size_t w = 0; w < count; ++w) {
+            pairs += static_cast<size_t>(std::popcount(a[w] & b[w]));
+        }
+        return pairs;
+    }
+
+  public:
+    VoxelGrid(const Vec3l &min, const Vec3l &max)
+        : low(min), high(max), width(max.x - min.x + 1), height(max.y - min.y + 1),
+          depth(max.z - min.z + 1), rowWords(static_cast<size_t>((width + 63) / 64)),
+          words(rowWords * static_cast<size_t>(height * depth)) {}
+
+    const Vec3l &min() const { return low; }
+    const Vec3l &max() const { return high; }
+
+    // pos is inside the box
+    bool contains(const Vec3l &pos) const {
+        return pos.x >= low.x and pos.y >= low.y and pos.z >= low.z and pos.x <= high.x and
+               pos.y <= high.y and pos.z <= high.z;
+    }
+
+    // pos has to be inside the box for test(), set() and reset()
+    bool test(const Vec3l &pos) const { return (words[wordOf(pos)] & bitOf(pos, low)) != 0; }
+    void set(const Vec3l &pos) { words[wordOf(pos)] |= bitOf(pos, low); }
+    void reset(const Vec3l &pos) { words[wordOf(pos)] &= ~bitOf(pos, low); }
+
+    // set or reset voxels (x0, y, z) .. (x1, y, z), inside the box
+    void setSpan(const int64_t y, const int64_t z, const int64_t x0, const int64_t x1,
+                 const bool value = true) {
+        auto *row = &words[rowStart(y - low.y, z - low.z)];
+        const auto from = x0 - low.x;
+        const auto to = x1 - low.x;
+        for (auto w = static_cast<size_t>(from / 64); w <= static_cast<size_t>(to / 64); ++w) {
+            const auto mask = spanMask(w, from, to);
+            row[w] = value ? row[w] | mask : row[w] & ~mask;
+        }
+    }
+
+    // number of set voxels
+    size_t count() const {
+        size_t set = 0;
+        for (const auto word : words) {
+            set += static_cast<size_t>(std::popcount(word));
+        }
+        return set;
+    }
+
+    // Number of faces between a set voxel of this grid and a set voxel of
+    // other, i.e. 6 * count() - facesTouching(*this) are the free faces.
+    // Both grids need the same box.
+    size_t facesTouching(const VoxelGrid &other) const {
+        if (low != other.low or high != other.high) {
+            throw std::invalid_argument("VoxelGrid::facesTouching");
+        }
+        size_t faces = 0;
+        for (int64_t z = 0; z < depth; ++z) {
+            for (int64_t y = 0; y < height; ++y) {
+                const auto *row = &words[rowStart(y, z)];
+                faces += pairsAlongX(row, &other.words[rowStart(y, z)], rowWords);
+                if (y > 0) {
+                    faces += pairsInRow(row, &other.words[rowStart(y - 1, z)], rowWords);
+                }
+                if (y + 1 < height) {
+                    faces += pairsInRow(row, &other.words[rowStart(y + 1, z)], rowWords);
+                }
+                if (z > 0) {
+                    faces += pairsInRow(row, &other.words[rowStart(y, z - 1)], rowWords);
+                }
+                if (z + 1 < depth) {
+                    faces += pairsInRow(row, &other.words[rowStart(y, z + 1)], rowWords);
+                }
+            }
+        }
+        return faces;
+    }
+
+    // The voxels not set in this grid that are connected to start through
+    // faces, start must not be set. Scanline fill: every seed is widened to
+    // the whole free run of its row, then the rows around it get one seed
+    // per free run next to that span.
+    VoxelGrid reachable(const Vec3l &start) const {
+        VoxelGrid filled{low, high};
+        // free and not yet filled bits of word w of row (y, z)
+        const auto open = [&](const size_t row, const size_t w) {
+            const auto valid = w + 1 < rowWords or width % 64 == 0
+                                   ? ~uint64_t{0}
+                                   : (uint64_t{1} << (width % 64)) - 1;
+            return ~(words[row + w] | filled.words[row + w]) & valid;
+        };
+        std::vector<Vec3l> seeds{start - low};
+        while (!seeds.empty()) {
+            const auto seed = seeds.back();
+            seeds.pop_back();
+            const auto row = rowStart(seed.y, seed.z);
+            auto w = static_cast<size_t>(seed.x / 64);
+            const auto bit = seed.x % 64;
+            if (((open(row, w) >> bit) & 1) == 0) {
+                continue;
+            }
+            // widen to the right, then to the left, a run ending at a word
+            // boundary continues in the next word
+            auto ones = std::countr_one(open(row, w) >> bit);
+            int64_t to = seed.x + ones - 1;
+            while (to % 64 == 63 and w + 1 < rowWords and
+                   (ones = std::countr_one(open(row, ++w))) > 0) {
+                to += ones;
+            }
+            w = static_cast<size_t>(seed.x / 64);
+            ones = std::countl_one(open(row, w) << (63 - bit));
+            int64_t from = seed.x - ones + 1;
+            while (from % 64 == 0 and w > 0 and (ones = std::countl_one(open(row, --w))) > 0) {
+                from -= ones;
+            }
+            filled.setSpan(seed.y + low.y, seed.z + low.z, from + low.x, to + low.x);
+
+            const auto seedRow = [&](const int64_t y, const int64_t z) {
+                if (y < 0 or z < 0 or y >= height or z >= depth) {
+                    return;
+                }
+                const auto next = rowStart(y, z);
+                uint64_t carry = 0;
+                for (auto i = static_cast<size_t>(from / 64); i <= static_cast<size_t>(to / 64);
+                     ++i) {
+                    const auto free = open(next, i) & spanMask(i, from, to);
+                    // first bit of every free run
+                    for (auto starts = free & ~(free << 1 | carry); starts != 0;
+                         starts &= starts - 1) {
+                        seeds.push_back({static_cast<int64_t>(i) * 64 + std::countr_zero(starts),
+                                         y, z});
+                    }
+                    carry = free >> 63;
+                }
+            };
+            seedRow(seed.y - 1, seed.z);
+            seedRow(seed.y + 1, seed.z);
+            seedRow(seed.y, seed.z - 1);
+            seedRow(seed.y, seed.z + 1);
+        }
+        return filled;
+    }
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+#include "mappedfile.hpp"
+#include "readahead.hpp"
+
+// The complete content of an input file.
+// usage:
+// const WholeFile input{argv[1]};
+// input.view() - all bytes as std::string_view
+//
+// The file is memory mapped if possible. Empty files and pipes are read into
+// memory instead, "-" reads stdin.
+class WholeFile {
+    MappedFile mappedFile{};
+    std::string content{};
+    std::string_view bytes{};
+
+  public:
+    WholeFile(const char *filename) : mappedFile(filename) {
+        if (mappedFile.isMapped()) {
+            bytes = mappedFile.view();
+            return;
+        }
+        if (std::string_view{filename} == "-") {
+            content = ReadAhead{STDIN_FILENO}.readAll();
+        } else {
+            std::ifstream infile{filename};
+            content.assign(std::istreambuf_iterator<char>{infile}, {});
+        }
+        bytes = content;
+    }
+
+    // bytes may point into content
+    WholeFile(const WholeFile &) = delete;
+    WholeFile &operator=(const WholeFile &) = delete;
+
+    std::string_view view() const { return bytes; }
+};